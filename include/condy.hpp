@@ -10,18 +10,32 @@
 
 #include "condy/async_operations.hpp"   // IWYU pragma: export
 #include "condy/awaiter_operations.hpp" // IWYU pragma: export
+#include "condy/barrier.hpp"            // IWYU pragma: export
+#include "condy/broadcast_channel.hpp"  // IWYU pragma: export
 #include "condy/buffers.hpp"            // IWYU pragma: export
 #include "condy/channel.hpp"            // IWYU pragma: export
 #include "condy/coro.hpp"               // IWYU pragma: export
 #include "condy/futex.hpp"              // IWYU pragma: export
 #include "condy/helpers.hpp"            // IWYU pragma: export
+#include "condy/interval.hpp"           // IWYU pragma: export
+#include "condy/local_channel.hpp"      // IWYU pragma: export
+#include "condy/oneshot.hpp"            // IWYU pragma: export
 #include "condy/pmr.hpp"                // IWYU pragma: export
+#include "condy/priority.hpp"           // IWYU pragma: export
 #include "condy/provided_buffers.hpp"   // IWYU pragma: export
 #include "condy/runtime.hpp"            // IWYU pragma: export
 #include "condy/runtime_options.hpp"    // IWYU pragma: export
+#include "condy/runtime_pool.hpp"       // IWYU pragma: export
+#include "condy/runtime_stats.hpp"      // IWYU pragma: export
+#include "condy/rwlock.hpp"             // IWYU pragma: export
+#include "condy/select.hpp"             // IWYU pragma: export
+#include "condy/semaphore.hpp"          // IWYU pragma: export
 #include "condy/sync_wait.hpp"          // IWYU pragma: export
 #include "condy/task.hpp"               // IWYU pragma: export
+#include "condy/timer.hpp"              // IWYU pragma: export
+#include "condy/unbounded_channel.hpp"  // IWYU pragma: export
 #include "condy/version.hpp"            // IWYU pragma: export
+#include "condy/wait_group.hpp"         // IWYU pragma: export
 
 /**
  * @brief The main namespace for the Condy library.
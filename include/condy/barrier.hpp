@@ -0,0 +1,124 @@
+/**
+ * @file barrier.hpp
+ * @brief Reusable barrier for coroutines.
+ * @details This file defines condy::Barrier, which lets a group of coroutines
+ * wait for each other at a synchronization point. It can be used across
+ * different Runtimes.
+ */
+
+#pragma once
+
+#include "condy/parking_lot.hpp"
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+namespace condy {
+
+/**
+ * @brief Reusable barrier.
+ * @details Each phase completes when the expected number of participants have
+ * arrived, after which the barrier is reset for the next phase. Arriving is a
+ * single atomic operation, and only the last participant of a phase wakes up
+ * the awaiting coroutines.
+ */
+class Barrier {
+public:
+    /**
+     * @brief Construct a new Barrier object
+     * @param expected Number of participants in each phase.
+     */
+    Barrier(uint32_t expected) : state_(expected), expected_(expected) {
+        assert(expected > 0);
+    }
+
+    Barrier(const Barrier &) = delete;
+    Barrier &operator=(const Barrier &) = delete;
+    Barrier(Barrier &&) = delete;
+    Barrier &operator=(Barrier &&) = delete;
+
+public:
+    class ArriveCondition;
+    /**
+     * @brief Arrive at the barrier and wait until the current phase completes.
+     * @return int32_t 0 if the phase completes; -ECANCELED if the wait
+     * operation is canceled while waiting. The arrival is not undone on
+     * cancellation.
+     */
+    detail::ParkSender<ArriveCondition> arrive_and_wait() noexcept;
+
+    /**
+     * @brief Arrive at the barrier without waiting, and leave it, so that
+     * following phases expect one participant less.
+     * @note This function is thread-safe and can be called from any thread.
+     */
+    void arrive_and_drop() noexcept {
+        [[maybe_unused]] auto prev =
+            expected_.fetch_sub(1, std::memory_order_relaxed);
+        assert(prev > 0);
+        arrive_();
+    }
+
+    /**
+     * @brief Get the current phase number, which wraps around on overflow.
+     */
+    uint32_t phase() const noexcept {
+        return phase_of_(state_.load(std::memory_order_acquire));
+    }
+
+private:
+    static uint32_t phase_of_(uint64_t state) noexcept {
+        return static_cast<uint32_t>(state >> 32);
+    }
+
+    // Return the phase arrived at
+    uint32_t arrive_() noexcept {
+        auto state = state_.load(std::memory_order_relaxed);
+        while (true) {
+            uint32_t phase = phase_of_(state);
+            uint32_t remaining = static_cast<uint32_t>(state);
+            assert(remaining > 0);
+            uint64_t next =
+                remaining > 1
+                    ? state - 1
+                    : (uint64_t(phase + 1) << 32) |
+                          expected_.load(std::memory_order_relaxed);
+            if (state_.compare_exchange_weak(state, next,
+                                             std::memory_order_acq_rel)) {
+                if (remaining == 1) {
+                    detail::ParkingLot::instance().unpark(&state_, SIZE_MAX,
+                                                          0);
+                }
+                return phase;
+            }
+        }
+    }
+
+private:
+    // Phase number in the upper half, remaining participants in the lower half
+    std::atomic_uint64_t state_;
+    std::atomic_uint32_t expected_;
+};
+
+class Barrier::ArriveCondition {
+public:
+    ArriveCondition(Barrier &barrier) : barrier_(barrier) {}
+
+    const void *key() const noexcept { return &barrier_.state_; }
+
+    void arrive() noexcept { phase_ = barrier_.arrive_(); }
+
+    bool should_park() noexcept { return barrier_.phase() == phase_; }
+
+private:
+    Barrier &barrier_;
+    uint32_t phase_ = 0;
+};
+
+inline detail::ParkSender<Barrier::ArriveCondition>
+Barrier::arrive_and_wait() noexcept {
+    return ArriveCondition{*this};
+}
+
+} // namespace condy
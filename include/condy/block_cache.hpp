@@ -0,0 +1,143 @@
+/**
+ * @file block_cache.hpp
+ * @brief Runtime-local cache of memory blocks.
+ * @details This file defines BlockCache, a size-class free list cache used to
+ * recycle short-lived allocations, like coroutine frames, in the runtime
+ * thread.
+ */
+
+#pragma once
+
+#include "condy/context.hpp"
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace condy {
+
+namespace detail {
+
+/**
+ * @brief Size-class free list cache of memory blocks.
+ * @details Blocks are allocated with a small header recording their size
+ * class, so that they can be freed without knowing their size, and recycled by
+ * any cache. Allocation and deallocation use the cache of the current thread
+ * (see Context), if any, and fall back to the global operator new and delete
+ * otherwise. Since a cache is only accessed by its own thread, blocks freed in
+ * a different thread than the one allocating them are safe.
+ */
+class BlockCache {
+public:
+    BlockCache() = default;
+    ~BlockCache() { release(); }
+
+    BlockCache(const BlockCache &) = delete;
+    BlockCache &operator=(const BlockCache &) = delete;
+    BlockCache(BlockCache &&) = delete;
+    BlockCache &operator=(BlockCache &&) = delete;
+
+public:
+    /**
+     * @brief Allocate a block of at least size bytes, aligned to
+     * __STDCPP_DEFAULT_NEW_ALIGNMENT__.
+     * @throws std::bad_alloc If the allocation fails.
+     */
+    static void *allocate(size_t size) {
+        size_t cls = size_class_(size + header_size);
+        BlockCache *cache = Context::current().block_cache();
+        void *block = nullptr;
+        if (cache != nullptr && cls < num_size_classes) {
+            block = cache->pop_(cls);
+        }
+        if (block == nullptr) {
+            size_t block_size =
+                cls < num_size_classes ? class_size_(cls) : size + header_size;
+            block = ::operator new(block_size);
+        }
+        static_cast<Header *>(block)->size_class = cls;
+        return static_cast<char *>(block) + header_size;
+    }
+
+    /**
+     * @brief Deallocate a block returned by allocate().
+     */
+    static void deallocate(void *ptr) noexcept {
+        if (ptr == nullptr) {
+            return;
+        }
+        void *block = static_cast<char *>(ptr) - header_size;
+        size_t cls = static_cast<Header *>(block)->size_class;
+        BlockCache *cache = Context::current().block_cache();
+        if (cache != nullptr && cls < num_size_classes &&
+            cache->push_(cls, block)) {
+            return;
+        }
+        ::operator delete(block);
+    }
+
+    /**
+     * @brief Release all cached blocks to the global allocator.
+     */
+    void release() noexcept {
+        for (size_t cls = 0; cls < num_size_classes; cls++) {
+            while (void *block = pop_(cls)) {
+                ::operator delete(block);
+            }
+        }
+    }
+
+private:
+    struct Header {
+        uint32_t size_class;
+    };
+
+    struct FreeBlock {
+        FreeBlock *next;
+    };
+
+    static constexpr size_t header_size = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+    static_assert(sizeof(Header) <= header_size);
+
+    static constexpr size_t min_class_shift = 6; // 64 bytes
+    static constexpr size_t num_size_classes = 8; // Up to 8 KiB
+    static constexpr size_t max_cached_bytes = 1024 * 1024; // Per size class
+
+    static constexpr size_t class_size_(size_t cls) noexcept {
+        return size_t(1) << (cls + min_class_shift);
+    }
+
+    static constexpr size_t size_class_(size_t size) noexcept {
+        size_t width = std::bit_width(size - 1);
+        return width <= min_class_shift ? 0 : width - min_class_shift;
+    }
+
+    void *pop_(size_t cls) noexcept {
+        FreeBlock *block = free_lists_[cls];
+        if (block == nullptr) {
+            return nullptr;
+        }
+        free_lists_[cls] = block->next;
+        counts_[cls]--;
+        return block;
+    }
+
+    bool push_(size_t cls, void *ptr) noexcept {
+        if ((counts_[cls] + 1) * class_size_(cls) > max_cached_bytes) {
+            return false;
+        }
+        auto *block = static_cast<FreeBlock *>(ptr);
+        block->next = free_lists_[cls];
+        free_lists_[cls] = block;
+        counts_[cls]++;
+        return true;
+    }
+
+private:
+    FreeBlock *free_lists_[num_size_classes] = {};
+    size_t counts_[num_size_classes] = {};
+};
+
+} // namespace detail
+
+} // namespace condy
@@ -0,0 +1,371 @@
+/**
+ * @file broadcast_channel.hpp
+ * @brief Thread-safe broadcast channel type for publish-subscribe.
+ * @details This file defines a thread-safe broadcast channel type, which
+ * delivers every published item to all subscribers, across different Runtimes.
+ */
+
+#pragma once
+
+#include "condy/context.hpp"
+#include "condy/intrusive.hpp"
+#include "condy/invoker.hpp"
+#include "condy/runtime.hpp"
+#include "condy/type_traits.hpp"
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace condy {
+
+/**
+ * @brief Thread-safe bounded broadcast channel.
+ * @tparam T Type of the items transmitted through the channel.
+ * @details Items published to the channel are stored once in a shared ring
+ * buffer, and each Subscriber reads them with its own cursor. Subscribers
+ * receive shared pointers to the stored items, so neither memory nor copies
+ * grow with the number of subscribers.
+ *
+ * Publishing never waits. When the buffer is full, the oldest item is
+ * overwritten, and subscribers that have not received it yet are lagged: their
+ * next receive fails with -EOVERFLOW, and their cursor jumps to the oldest
+ * item still in the buffer.
+ *
+ * Awaiting subscribers are all woken up by the next publish, after the
+ * internal lock is released. Subscribers running on the same Runtime share a
+ * single cross-runtime notification.
+ */
+template <typename T> class BroadcastChannel {
+public:
+    using ItemPtr = std::shared_ptr<const T>;
+
+    class Subscriber;
+    class [[nodiscard]] RecvSender;
+
+    /**
+     * @brief Construct a new BroadcastChannel object
+     * @param capacity Number of most recent items kept for subscribers. It is
+     * rounded up to a power of two, and to at least one.
+     */
+    BroadcastChannel(size_t capacity)
+        : slots_(std::bit_ceil(std::max(capacity, size_t(1)))) {}
+    ~BroadcastChannel() { close(); }
+
+    BroadcastChannel(const BroadcastChannel &) = delete;
+    BroadcastChannel &operator=(const BroadcastChannel &) = delete;
+    BroadcastChannel(BroadcastChannel &&) = delete;
+    BroadcastChannel &operator=(BroadcastChannel &&) = delete;
+
+public:
+    /**
+     * @brief Publish an item to all subscribers.
+     * @param item The item to be published.
+     * @return int32_t 0 if the item was successfully published; -EPIPE if the
+     * channel is closed.
+     * @throws std::bad_alloc If the allocation of the shared item fails.
+     */
+    int32_t publish(T item) {
+        auto ptr = std::make_shared<const T>(std::move(item));
+        // Released outside the lock
+        ItemPtr evicted;
+        WakeList<RecvFinishHandleBase> wake_list;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (closed_) {
+                return -EPIPE;
+            }
+            evicted = std::exchange(slots_[tail_ & mask_()], std::move(ptr));
+            tail_++;
+            wake_list = take_waiters_();
+        }
+        wake_(std::move(wake_list));
+        return 0;
+    }
+
+    /**
+     * @brief Create a new subscriber.
+     * @details The subscriber receives items published after this call.
+     * @warning The subscriber must not outlive the channel.
+     */
+    Subscriber subscribe() noexcept {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return Subscriber(*this, tail_);
+    }
+
+    /**
+     * @brief Get the capacity of the channel.
+     */
+    size_t capacity() const noexcept { return slots_.size(); }
+
+    /**
+     * @brief Check if the channel is closed.
+     * @warning This function may not be accurate in multithreaded scenarios.
+     */
+    bool is_closed() const noexcept {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return closed_;
+    }
+
+    /**
+     * @brief Close the channel.
+     * @details After the channel is closed, no more items can be published.
+     * Subscribers can still receive the remaining items, after which receives
+     * fail with -EPIPE.
+     * @note This function is idempotent.
+     */
+    void close() noexcept {
+        WakeList<RecvFinishHandleBase> wake_list;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (closed_) {
+                return;
+            }
+            closed_ = true;
+            wake_list = take_waiters_();
+        }
+        wake_(std::move(wake_list));
+    }
+
+private:
+    class RecvFinishHandleBase;
+    template <typename Receiver> class RecvFinishHandle;
+
+    std::pair<int32_t, ItemPtr> try_recv_(size_t &cursor) noexcept {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return try_recv_inner_(cursor);
+    }
+
+    std::pair<int32_t, ItemPtr>
+    request_recv_(RecvFinishHandleBase *finish_handle) noexcept {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto result = try_recv_inner_(finish_handle->cursor());
+        if (result.first != -EAGAIN) {
+            return result;
+        }
+        waiters_.push_back(finish_handle);
+        detail::Context::current().runtime()->pend_work();
+        return result;
+    }
+
+    bool cancel_recv_(RecvFinishHandleBase *finish_handle) noexcept {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return waiters_.remove(finish_handle);
+    }
+
+private:
+    std::pair<int32_t, ItemPtr> try_recv_inner_(size_t &cursor) noexcept {
+        size_t oldest = tail_ > capacity() ? tail_ - capacity() : 0;
+        if (cursor < oldest) {
+            // Lagged, skip the overwritten items
+            cursor = oldest;
+            return {-EOVERFLOW, nullptr};
+        }
+        if (cursor < tail_) {
+            return {0, slots_[cursor++ & mask_()]};
+        }
+        if (closed_) {
+            return {-EPIPE, nullptr};
+        }
+        return {-EAGAIN, nullptr};
+    }
+
+    template <typename Handle>
+    using WakeList = IntrusiveSingleList<Handle, &Handle::wake_entry_>;
+
+    // Complete all waiters under the lock, but schedule them after the lock
+    // is released.
+    WakeList<RecvFinishHandleBase> take_waiters_() noexcept {
+        WakeList<RecvFinishHandleBase> wake_list;
+        RecvFinishHandleBase *handle = nullptr;
+        while ((handle = waiters_.pop_front()) != nullptr) {
+            auto result = try_recv_inner_(handle->cursor());
+            assert(result.first != -EAGAIN);
+            handle->set_result(std::move(result));
+            wake_list.push_back(handle);
+        }
+        return wake_list;
+    }
+
+    static void wake_(WakeList<RecvFinishHandleBase> wake_list) noexcept {
+        RecvFinishHandleBase *handle = nullptr;
+        while ((handle = wake_list.pop_front()) != nullptr) {
+            handle->schedule();
+        }
+    }
+
+    size_t mask_() const noexcept { return slots_.size() - 1; }
+
+private:
+    template <typename Handle>
+    using HandleList = IntrusiveDoubleList<Handle, &Handle::link_entry_>;
+
+    mutable std::mutex mutex_;
+    HandleList<RecvFinishHandleBase> waiters_;
+    size_t tail_ = 0;
+    std::vector<ItemPtr> slots_;
+    bool closed_ = false;
+};
+
+/**
+ * @brief Subscriber of a BroadcastChannel.
+ * @details A subscriber receives every item published after its creation, in
+ * order, unless it lags behind by more than the capacity of the channel. A
+ * subscriber must only be used by one coroutine at a time.
+ */
+template <typename T> class BroadcastChannel<T>::Subscriber {
+public:
+    /**
+     * @brief Try to receive the next item.
+     * @return std::pair<int32_t, ItemPtr> 0 and the item if successful;
+     * -EOVERFLOW if the subscriber lagged behind and missed some items;
+     * -EPIPE if the channel is closed and no more items can be received;
+     * -EAGAIN if no new item is available.
+     */
+    std::pair<int32_t, ItemPtr> try_recv() noexcept {
+        return channel_->try_recv_(cursor_);
+    }
+
+    /**
+     * @brief Receive the next item, awaiting if necessary.
+     * @return std::pair<int32_t, ItemPtr> 0 and the item if successful;
+     * -EOVERFLOW if the subscriber lagged behind and missed some items;
+     * -EPIPE if the channel is closed and no more items can be received;
+     * -ECANCELED if the operation was cancelled while waiting.
+     */
+    RecvSender recv() noexcept { return {*channel_, cursor_}; }
+
+private:
+    Subscriber(BroadcastChannel &channel, size_t cursor)
+        : channel_(&channel), cursor_(cursor) {}
+
+    friend class BroadcastChannel;
+
+    BroadcastChannel *channel_;
+    size_t cursor_;
+};
+
+template <typename T>
+class BroadcastChannel<T>::RecvFinishHandleBase : public WorkInvoker {
+public:
+    RecvFinishHandleBase(size_t &cursor) : cursor_(cursor) {}
+
+    void schedule() noexcept {
+        assert(runtime_ != nullptr);
+        runtime_->schedule(this);
+    }
+
+    size_t &cursor() noexcept { return cursor_; }
+
+    void set_result(std::pair<int32_t, ItemPtr> result) noexcept {
+        result_ = std::move(result);
+    }
+
+public:
+    DoubleLinkEntry link_entry_;
+    SingleLinkEntry wake_entry_;
+
+protected:
+    Runtime *runtime_ = nullptr;
+    size_t &cursor_;
+    // Internal error if not set
+    std::pair<int32_t, ItemPtr> result_ = {-ENOTRECOVERABLE, nullptr};
+};
+
+template <typename T>
+template <typename Receiver>
+class BroadcastChannel<T>::RecvFinishHandle
+    : public InvokerAdapter<RecvFinishHandle<Receiver>, RecvFinishHandleBase> {
+public:
+    using Base =
+        InvokerAdapter<RecvFinishHandle<Receiver>, RecvFinishHandleBase>;
+
+    RecvFinishHandle(BroadcastChannel &channel, size_t &cursor,
+                     Receiver receiver)
+        : Base(cursor), channel_(channel), receiver_(std::move(receiver)) {}
+
+    void start(Runtime *runtime) noexcept {
+        this->runtime_ = runtime;
+        this->set_priority(detail::Context::current().priority());
+        auto result = channel_.request_recv_(this);
+        if (result.first != -EAGAIN) {
+            std::move(receiver_)(std::move(result));
+            return;
+        }
+
+        auto stop_token = receiver_.get_stop_token();
+        if (stop_token.stop_possible()) {
+            stop_callback_.emplace(std::move(stop_token), Cancellation{this});
+        }
+    }
+
+    void invoke() noexcept {
+        stop_callback_.reset();
+        assert(this->runtime_ != nullptr);
+        this->runtime_->resume_work();
+        std::move(receiver_)(std::move(this->result_));
+    }
+
+private:
+    void cancel_() noexcept {
+        if (channel_.cancel_recv_(this)) {
+            // Successfully canceled
+            assert(this->result_.first == -ENOTRECOVERABLE);
+            this->result_.first = -ECANCELED;
+            assert(this->runtime_ != nullptr);
+            this->runtime_->schedule(this);
+        }
+    }
+
+    struct Cancellation {
+        RecvFinishHandle *self;
+        void operator()() noexcept { self->cancel_(); }
+    };
+
+    using StopCallbackType =
+        stop_callback_t<stop_token_t<Receiver>, Cancellation>;
+
+private:
+    BroadcastChannel &channel_;
+    Receiver receiver_;
+    std::optional<StopCallbackType> stop_callback_;
+};
+
+template <typename T> class BroadcastChannel<T>::RecvSender {
+public:
+    using ReturnType = std::pair<int32_t, ItemPtr>;
+
+    RecvSender(BroadcastChannel &channel, size_t &cursor)
+        : channel_(channel), cursor_(cursor) {}
+
+    template <typename Receiver> auto connect(Receiver receiver) noexcept {
+        return OperationState<Receiver>(channel_, cursor_,
+                                        std::move(receiver));
+    }
+
+private:
+    template <typename Receiver>
+    class OperationState
+        : public BroadcastChannel<T>::template RecvFinishHandle<Receiver> {
+    public:
+        using Base =
+            typename BroadcastChannel<T>::template RecvFinishHandle<Receiver>;
+        using Base::Base;
+
+        void start(unsigned int /*flags*/) noexcept {
+            auto *runtime = detail::Context::current().runtime();
+            Base::start(runtime);
+        }
+    };
+
+    BroadcastChannel &channel_;
+    size_t &cursor_;
+};
+
+} // namespace condy
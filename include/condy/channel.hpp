@@ -13,47 +13,68 @@
 #include "condy/runtime.hpp"
 #include "condy/type_traits.hpp"
 #include "condy/utils.hpp"
+#include <algorithm>
+#include <atomic>
 #include <bit>
 #include <cerrno>
 #include <cstddef>
 #include <cstdint>
 #include <new>
 #include <optional>
+#include <span>
 #include <type_traits>
 
 namespace condy {
 
+namespace detail {
+
+template <typename Receiver, typename... Channels> class SelectOperationState;
+
+// Channel shared by Runtimes of different threads
+struct SharedChannelPolicy {
+    using Mutex = std::mutex;
+    template <typename U> using Atomic = std::atomic<U>;
+    template <typename U> using AtomicRef = std::atomic_ref<U>;
+
+    static void schedule(Runtime *runtime, WorkInvoker *work) noexcept {
+        runtime->schedule(work);
+    }
+};
+
 /**
- * @brief Thread-safe bounded channel for communication and synchronization.
- * @tparam T Type of the items transmitted through the channel.
- * @tparam N When the capacity is less than or equal to N, the channel uses
- * stack storage for buffering; otherwise, it uses heap storage.
- * @details This class provides a thread-safe channel for communication and
- * synchronization for both intra-Runtime and inter-Runtime scenarios. It
- * supports both buffered and unbuffered modes, as well as push and pop
- * operations that can be awaited in coroutines. The internal implementation
- * utilizes msg_ring operations of io_uring for efficient cross-runtime
- * notifications.
+ * @brief Bounded channel implementation shared by Channel and LocalChannel.
+ * @tparam Policy Provides the Mutex type guarding the awaiting operations; the
+ * Atomic and AtomicRef types of the ring buffer, its indices and counters; and
+ * schedule() used to resume awaiting operations on their Runtime.
  */
-template <typename T, size_t N = 2> class Channel {
+template <typename T, size_t N, typename Policy> class ChannelImpl {
+    using Mutex = typename Policy::Mutex;
+    template <typename U> using Atomic = typename Policy::template Atomic<U>;
+    template <typename U>
+    using AtomicRef = typename Policy::template AtomicRef<U>;
+
 public:
     /**
-     * @brief Construct a new Channel object
+     * @brief Construct a new channel
      * @param capacity Capacity of the channel. If capacity is zero, the channel
      * operates in unbuffered mode.
      */
-    Channel(size_t capacity)
-        : buffer_(capacity ? std::bit_ceil(capacity) : 0) {}
-    ~Channel() {
-        std::lock_guard<std::mutex> lock(mutex_);
+    ChannelImpl(size_t capacity)
+        : buffer_(capacity ? std::bit_ceil(capacity) : 0) {
+        for (size_t i = 0; i < buffer_.capacity(); i++) {
+            buffer_[i].sequence = 0;
+        }
+    }
+    ~ChannelImpl() {
+        std::lock_guard<Mutex> lock(mutex_);
         push_close_inner_();
         destruct_all_();
     }
 
-    Channel(const Channel &) = delete;
-    Channel &operator=(const Channel &) = delete;
-    Channel(Channel &&) = delete;
-    Channel &operator=(Channel &&) = delete;
+    ChannelImpl(const ChannelImpl &) = delete;
+    ChannelImpl &operator=(const ChannelImpl &) = delete;
+    ChannelImpl(ChannelImpl &&) = delete;
+    ChannelImpl &operator=(ChannelImpl &&) = delete;
 
 public:
     /**
@@ -65,8 +86,14 @@ public:
     template <typename U>
         requires std::is_same_v<std::decay_t<U>, T>
     int32_t try_push(U &&item) noexcept {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (closed_) {
+        if (closed_.load(std::memory_order_acquire)) {
+            return -EPIPE;
+        }
+        if (try_push_fast_(std::forward<U>(item))) [[likely]] {
+            return 0;
+        }
+        std::lock_guard<Mutex> lock(mutex_);
+        if (closed_.load(std::memory_order_relaxed)) {
             return -EPIPE;
         }
         if (try_push_inner_(std::forward<U>(item))) {
@@ -82,11 +109,15 @@ public:
      * -EAGAIN if the channel is empty.
      */
     std::pair<int32_t, T> try_pop() noexcept {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto item = try_pop_inner_();
-        if (item.has_value()) {
+        auto item = try_pop_fast_();
+        if (item.has_value()) [[likely]] {
             return {0, std::move(item.value())};
-        } else if (closed_) {
+        }
+        std::lock_guard<Mutex> lock(mutex_);
+        auto result = try_pop_inner_();
+        if (result.has_value()) {
+            return {0, std::move(result.value())};
+        } else if (closed_.load(std::memory_order_relaxed)) {
             return {-EPIPE, T()};
         } else {
             return {-EAGAIN, T()};
@@ -94,26 +125,90 @@ public:
     }
 
     void force_push(T item) noexcept {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (closed_) [[unlikely]] {
+        if (closed_.load(std::memory_order_acquire)) [[unlikely]] {
             panic_on("Push to closed channel");
         }
-        if (try_push_inner_(std::move(item))) [[likely]] {
+        if (try_push_fast_(std::move(item))) [[likely]] {
             return;
         }
-        // This is safe because if try_push_inner_ returns false, the item has
-        // not been moved into the channel.
+        std::lock_guard<Mutex> lock(mutex_);
+        if (closed_.load(std::memory_order_relaxed)) [[unlikely]] {
+            panic_on("Push to closed channel");
+        }
+        // This is safe because if try_push_fast_ or try_push_inner_ returns
+        // false, the item has not been moved into the channel.
         // NOLINTBEGIN(bugprone-use-after-move)
+        if (register_awaiter_(
+                [&]() { return try_push_inner_(std::move(item)); })) {
+            return;
+        }
         auto *fake_handle =
             new (std::nothrow) FakePushFinishHandle(std::move(item));
         // NOLINTEND(bugprone-use-after-move)
         if (!fake_handle) {
             panic_on("Allocation failed for PushFinishHandle");
         }
-        assert(pop_awaiters_.empty());
         push_awaiters_.push_back(fake_handle);
     }
 
+    /**
+     * @brief Try to push multiple items into the channel at once.
+     * @param items The items to be pushed into the channel. Pushed items are
+     * moved from the front of the span.
+     * @return int32_t The number of pushed items, which may be less than the
+     * size of the span; -EPIPE if the channel is closed; -EAGAIN if the
+     * channel is full.
+     * @details When possible, all items are pushed with a single
+     * synchronization step.
+     */
+    int32_t try_push_many(std::span<T> items) noexcept {
+        if (closed_.load(std::memory_order_acquire)) {
+            return -EPIPE;
+        }
+        if (items.empty()) {
+            return 0;
+        }
+        size_t n = try_push_many_fast_(items);
+        if (n > 0) [[likely]] {
+            return static_cast<int32_t>(n);
+        }
+        std::lock_guard<Mutex> lock(mutex_);
+        if (closed_.load(std::memory_order_relaxed)) {
+            return -EPIPE;
+        }
+        n = try_push_many_inner_(items);
+        return n > 0 ? static_cast<int32_t>(n) : -EAGAIN;
+    }
+
+    /**
+     * @brief Try to pop multiple items from the channel at once.
+     * @param out The span to store the popped items. Items are move-assigned
+     * to the front of the span, and at most out.size() items are popped.
+     * @return int32_t The number of popped items; -EPIPE if the channel is
+     * closed and no more items can be popped; -EAGAIN if the channel is
+     * empty.
+     * @details When possible, all items are popped with a single
+     * synchronization step.
+     */
+    int32_t try_pop_many(std::span<T> out) noexcept {
+        if (out.empty()) {
+            return 0;
+        }
+        size_t n = try_pop_many_fast_(out);
+        if (n > 0) [[likely]] {
+            return static_cast<int32_t>(n);
+        }
+        std::lock_guard<Mutex> lock(mutex_);
+        n = try_pop_many_inner_(out);
+        if (n > 0) {
+            return static_cast<int32_t>(n);
+        } else if (closed_.load(std::memory_order_relaxed)) {
+            return -EPIPE;
+        } else {
+            return -EAGAIN;
+        }
+    }
+
     class [[nodiscard]] MovePushSender;
     /**
      * @brief Push an item into the channel, awaiting if necessary.
@@ -152,6 +247,40 @@ public:
      */
     PopSender pop() noexcept { return {*this}; }
 
+    class [[nodiscard]] PushManySender;
+    /**
+     * @brief Push multiple items into the channel, awaiting if necessary.
+     * @param items The items to be pushed into the channel. Pushed items are
+     * moved from the front of the span.
+     * @return int32_t The number of pushed items, which is at least one
+     * unless the span is empty; -EPIPE if the channel is closed; -ECANCELED if
+     * the operation was cancelled while waiting.
+     * @details The operation only awaits while no item can be pushed. Once
+     * woken up, it pushes as many of the remaining items as possible without
+     * awaiting again.
+     * @note The caller must ensure that the items outlive this asynchronous
+     * operation.
+     */
+    PushManySender push_many(std::span<T> items) noexcept {
+        return {*this, items};
+    }
+
+    class [[nodiscard]] PopManySender;
+    /**
+     * @brief Pop multiple items from the channel, awaiting if necessary.
+     * @param out The span to store the popped items. Items are move-assigned
+     * to the front of the span, and at most out.size() items are popped.
+     * @return int32_t The number of popped items, which is at least one unless
+     * the span is empty; -EPIPE if the channel is closed and no more items can
+     * be popped; -ECANCELED if the operation was cancelled while waiting.
+     * @details The operation only awaits while the channel is empty. Once
+     * woken up, it pops as many of the available items as possible without
+     * awaiting again.
+     * @note The caller must ensure that the span outlives this asynchronous
+     * operation.
+     */
+    PopManySender pop_many(std::span<T> out) noexcept { return {*this, out}; }
+
     /**
      * @brief Get the capacity of the channel.
      */
@@ -162,26 +291,24 @@ public:
      * @warning This function may not be accurate in multithreaded scenarios.
      */
     size_t size() const noexcept {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return size_inner_();
+        // Load head first, so that the difference never underflows
+        size_t head = head_.load(std::memory_order_acquire);
+        size_t tail = tail_.load(std::memory_order_acquire);
+        return std::min(tail - head, buffer_.capacity());
     }
 
     /**
      * @brief Check if the channel is empty.
      * @warning This function may not be accurate in multithreaded scenarios.
      */
-    bool empty() const noexcept {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return empty_inner_();
-    }
+    bool empty() const noexcept { return size() == 0; }
 
     /**
      * @brief Check if the channel is closed.
      * @warning This function may not be accurate in multithreaded scenarios.
      */
     bool is_closed() const noexcept {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return closed_;
+        return closed_.load(std::memory_order_acquire);
     }
 
     /**
@@ -193,7 +320,7 @@ public:
      * @note This function is idempotent.
      */
     void push_close() noexcept {
-        std::lock_guard<std::mutex> lock(mutex_);
+        std::lock_guard<Mutex> lock(mutex_);
         push_close_inner_();
     }
 
@@ -205,34 +332,60 @@ private:
     class PopFinishHandleBase;
     template <typename Receiver> class PopFinishHandle;
 
+    template <typename Receiver> class PushManyFinishHandle;
+    template <typename Receiver> class PopManyFinishHandle;
+
+    template <typename Receiver, typename... Channels>
+    friend class detail::SelectOperationState;
+
     int32_t request_push_(PushFinishHandleBase *finish_handle) noexcept {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (closed_) {
+        if (closed_.load(std::memory_order_acquire)) {
+            return -EPIPE;
+        }
+        if (try_push_fast_(std::move(finish_handle->get_item()))) [[likely]] {
+            return 0;
+        }
+        std::lock_guard<Mutex> lock(mutex_);
+        if (closed_.load(std::memory_order_relaxed)) {
             return -EPIPE;
         }
-        if (try_push_inner_(std::move(finish_handle->get_item()))) {
+        if (register_awaiter_([&]() {
+                return try_push_inner_(std::move(finish_handle->get_item()));
+            })) {
             return 0;
         }
-        assert(pop_awaiters_.empty());
         push_awaiters_.push_back(finish_handle);
         detail::Context::current().runtime()->pend_work();
         return -EAGAIN;
     }
 
     bool cancel_push_(PushFinishHandleBase *finish_handle) noexcept {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return push_awaiters_.remove(finish_handle);
+        std::lock_guard<Mutex> lock(mutex_);
+        if (push_awaiters_.remove(finish_handle)) {
+            awaiters_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
     }
 
     std::pair<int32_t, T>
     request_pop_(PopFinishHandleBase *finish_handle) noexcept {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto result = try_pop_inner_();
-        if (result.has_value()) {
-            return {0, std::move(result.value())};
+        auto item = try_pop_fast_();
+        if (item.has_value()) [[likely]] {
+            return {0, std::move(item.value())};
+        }
+        std::lock_guard<Mutex> lock(mutex_);
+        if (register_awaiter_([&]() {
+                if (auto result = try_pop_inner_()) {
+                    item.emplace(std::move(result.value()));
+                    return true;
+                }
+                return false;
+            })) {
+            return {0, std::move(item.value())};
         }
-        assert(push_awaiters_.empty());
-        if (closed_) {
+        if (closed_.load(std::memory_order_relaxed)) {
+            awaiters_.fetch_sub(1, std::memory_order_relaxed);
             return {-EPIPE, T()};
         }
         pop_awaiters_.push_back(finish_handle);
@@ -241,127 +394,412 @@ private:
     }
 
     bool cancel_pop_(PopFinishHandleBase *finish_handle) noexcept {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return pop_awaiters_.remove(finish_handle);
+        std::lock_guard<Mutex> lock(mutex_);
+        if (pop_awaiters_.remove(finish_handle)) {
+            awaiters_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    int32_t request_push_many_(PushFinishHandleBase *finish_handle,
+                               std::span<T> items) noexcept {
+        if (closed_.load(std::memory_order_acquire)) {
+            return -EPIPE;
+        }
+        if (items.empty()) {
+            return 0;
+        }
+        size_t n = try_push_many_fast_(items);
+        if (n > 0) [[likely]] {
+            return static_cast<int32_t>(n);
+        }
+        std::lock_guard<Mutex> lock(mutex_);
+        if (closed_.load(std::memory_order_relaxed)) {
+            return -EPIPE;
+        }
+        if (register_awaiter_([&]() {
+                n = try_push_many_inner_(items);
+                return n > 0;
+            })) {
+            return static_cast<int32_t>(n);
+        }
+        // Await for the first item only
+        push_awaiters_.push_back(finish_handle);
+        detail::Context::current().runtime()->pend_work();
+        return -EAGAIN;
+    }
+
+    int32_t request_pop_many_(PopFinishHandleBase *finish_handle,
+                              std::span<T> out) noexcept {
+        if (out.empty()) {
+            return 0;
+        }
+        size_t n = try_pop_many_fast_(out);
+        if (n > 0) [[likely]] {
+            return static_cast<int32_t>(n);
+        }
+        std::lock_guard<Mutex> lock(mutex_);
+        if (register_awaiter_([&]() {
+                n = try_pop_many_inner_(out);
+                return n > 0;
+            })) {
+            return static_cast<int32_t>(n);
+        }
+        if (closed_.load(std::memory_order_relaxed)) {
+            awaiters_.fetch_sub(1, std::memory_order_relaxed);
+            return -EPIPE;
+        }
+        // Await for the first item only
+        pop_awaiters_.push_back(finish_handle);
+        detail::Context::current().runtime()->pend_work();
+        return -EAGAIN;
     }
 
 private:
+    // Lock-free paths, only taken when no operation is awaiting, so that items
+    // never overtake awaiting operations.
     template <typename U>
         requires std::is_same_v<std::decay_t<U>, T>
-    bool try_push_inner_(U &&item) noexcept {
-        if (!pop_awaiters_.empty()) {
-            assert(empty_inner_());
-            auto *pop_handle = pop_awaiters_.pop_front();
-            pop_handle->set_result({0, std::forward<U>(item)});
-            pop_handle->schedule();
-            return true;
+    bool try_push_fast_(U &&item) noexcept {
+        if (awaiters_.load(std::memory_order_acquire) != 0) {
+            return false;
+        }
+        if (!enqueue_(std::forward<U>(item))) {
+            return false;
         }
-        if (!full_inner_()) {
-            push_inner_(std::forward<U>(item));
+        wake_awaiters_();
+        return true;
+    }
+
+    std::optional<T> try_pop_fast_() noexcept {
+        if (awaiters_.load(std::memory_order_acquire) != 0) {
+            return std::nullopt;
+        }
+        auto item = dequeue_();
+        if (item.has_value()) {
+            wake_awaiters_();
+        }
+        return item;
+    }
+
+    size_t try_push_many_fast_(std::span<T> items) noexcept {
+        if (awaiters_.load(std::memory_order_acquire) != 0) {
+            return 0;
+        }
+        size_t n = enqueue_many_(items);
+        if (n > 0) {
+            wake_awaiters_();
+        }
+        return n;
+    }
+
+    size_t try_pop_many_fast_(std::span<T> out) noexcept {
+        if (awaiters_.load(std::memory_order_acquire) != 0) {
+            return 0;
+        }
+        size_t n = dequeue_many_(out);
+        if (n > 0) {
+            wake_awaiters_();
+        }
+        return n;
+    }
+
+    // Count the awaiter before retrying the operation under the lock. Paired
+    // with wake_awaiters_(): since the counter and the slot sequences are
+    // accessed with seq_cst, either the retry observes a concurrent lock-free
+    // operation, or that operation observes the awaiter and wakes it.
+    template <typename Func> bool register_awaiter_(Func &&retry) noexcept {
+        awaiters_.fetch_add(1, std::memory_order_seq_cst);
+        if (retry()) {
+            awaiters_.fetch_sub(1, std::memory_order_relaxed);
             return true;
         }
         return false;
     }
 
-    std::optional<T> try_pop_inner_() noexcept {
+    void wake_awaiters_() noexcept {
+        if (awaiters_.load(std::memory_order_seq_cst) == 0) [[likely]] {
+            return;
+        }
+        std::lock_guard<Mutex> lock(mutex_);
+        // Hand buffered items to awaiting pops
+        while (!pop_awaiters_.empty()) {
+            auto item = dequeue_locked_();
+            if (!item.has_value()) {
+                break;
+            }
+            if (!complete_pop_awaiter_(std::move(item.value()))) {
+                put_back_(std::move(item.value()));
+                break;
+            }
+        }
+        // Move items of awaiting pushes into the buffer
+        fill_from_push_awaiters_();
+    }
+
+    template <typename U>
+        requires std::is_same_v<std::decay_t<U>, T>
+    bool try_push_inner_(U &&item) noexcept {
         if (!push_awaiters_.empty()) {
-            assert(full_inner_());
-            auto *push_handle = push_awaiters_.pop_front();
-            T item = std::move(push_handle->get_item());
-            push_handle->set_result(0);
-            push_handle->schedule();
-            return pop_and_push_(std::move(item));
+            // Keep awaiting pushes ahead of this one
+            fill_from_push_awaiters_();
+            if (!push_awaiters_.empty()) {
+                return false;
+            }
         }
-        if (!empty_inner_()) {
-            T result = pop_inner_();
-            return result;
+        if (complete_pop_awaiter_(std::forward<U>(item))) {
+            return true;
         }
-        return std::nullopt;
+        return enqueue_(std::forward<U>(item));
     }
 
-    T pop_and_push_(T item) noexcept {
-        if (no_buffer_()) {
+    std::optional<T> try_pop_inner_() noexcept {
+        auto item = dequeue_locked_();
+        if (item.has_value()) {
+            fill_from_push_awaiters_();
             return item;
-        } else {
-            T result = pop_inner_();
-            push_inner_(std::move(item));
-            return result;
         }
+        // Unbuffered, or the buffer was drained concurrently
+        auto *push_handle = push_awaiters_.pop_front();
+        if (push_handle == nullptr) {
+            return std::nullopt;
+        }
+        awaiters_.fetch_sub(1, std::memory_order_relaxed);
+        item.emplace(std::move(push_handle->get_item()));
+        push_handle->set_result(0);
+        push_handle->schedule();
+        return item;
+    }
+
+    size_t try_push_many_inner_(std::span<T> items) noexcept {
+        size_t n = 0;
+        while (n < items.size() && try_push_inner_(std::move(items[n]))) {
+            n++;
+        }
+        return n;
+    }
+
+    size_t try_pop_many_inner_(std::span<T> out) noexcept {
+        size_t n = 0;
+        while (n < out.size()) {
+            auto item = try_pop_inner_();
+            if (!item.has_value()) {
+                break;
+            }
+            out[n++] = std::move(item.value());
+        }
+        return n;
     }
 
+    // Hand the item to the first awaiting pop that can still be claimed. The
+    // item is only moved on success.
     template <typename U>
         requires std::is_same_v<std::decay_t<U>, T>
-    void push_inner_(U &&item) noexcept {
-        assert(!full_inner_());
-        auto mask = buffer_.capacity() - 1;
-        buffer_[tail_ & mask].construct(std::forward<U>(item));
-        tail_++;
+    bool complete_pop_awaiter_(U &&item) noexcept {
+        PopFinishHandleBase *pop_handle = nullptr;
+        while ((pop_handle = pop_awaiters_.pop_front()) != nullptr) {
+            awaiters_.fetch_sub(1, std::memory_order_relaxed);
+            if (!pop_handle->try_claim()) {
+                // Select already completed by another channel, just drop it
+                continue;
+            }
+            pop_handle->set_result({0, std::forward<U>(item)});
+            pop_handle->schedule();
+            return true;
+        }
+        return false;
     }
 
-    T pop_inner_() noexcept {
-        assert(!empty_inner_());
-        auto mask = buffer_.capacity() - 1;
-        T item = std::move(buffer_[head_ & mask].get());
-        buffer_[head_ & mask].destroy();
-        head_++;
+    // Return an item dequeued for awaiting pops that were all dropped. The
+    // ring buffer can not be pushed at the head, so the item is kept aside
+    // and popped before the buffer. It counts as an awaiter, which disables
+    // the lock-free paths until it is popped.
+    void put_back_(T &&item) noexcept {
+        assert(!front_.has_value());
+        front_.emplace(std::move(item));
+        awaiters_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Must be called with the lock held.
+    std::optional<T> dequeue_locked_() noexcept {
+        if (front_.has_value()) [[unlikely]] {
+            std::optional<T> item = std::move(front_);
+            front_.reset();
+            awaiters_.fetch_sub(1, std::memory_order_relaxed);
+            return item;
+        }
+        return dequeue_();
+    }
+
+    void fill_from_push_awaiters_() noexcept {
+        PushFinishHandleBase *push_handle = nullptr;
+        while ((push_handle = push_awaiters_.front()) != nullptr) {
+            auto &item = push_handle->get_item();
+            if (!complete_pop_awaiter_(std::move(item)) &&
+                !enqueue_(std::move(item))) {
+                break;
+            }
+            push_awaiters_.pop_front();
+            awaiters_.fetch_sub(1, std::memory_order_relaxed);
+            push_handle->set_result(0);
+            push_handle->schedule();
+        }
+    }
+
+    // Bounded MPMC queue with per-slot sequence numbers. In the n-th lap over
+    // the buffer, a slot is free for push when its sequence is 2n, and ready
+    // for pop when its sequence is 2n + 1.
+    template <typename U>
+        requires std::is_same_v<std::decay_t<U>, T>
+    bool enqueue_(U &&item) noexcept {
+        auto [pos, n] = claim_(tail_, 1, 0);
+        if (n == 0) {
+            return false;
+        }
+        publish_(pos, std::forward<U>(item));
+        return true;
+    }
+
+    size_t enqueue_many_(std::span<T> items) noexcept {
+        auto [pos, n] = claim_(tail_, items.size(), 0);
+        for (size_t i = 0; i < n; i++) {
+            publish_(pos + i, std::move(items[i]));
+        }
+        return n;
+    }
+
+    std::optional<T> dequeue_() noexcept {
+        auto [pos, n] = claim_(head_, 1, 1);
+        if (n == 0) {
+            return std::nullopt;
+        }
+        std::optional<T> item;
+        consume_(pos, [&](T &&value) { item.emplace(std::move(value)); });
         return item;
     }
 
-    bool no_buffer_() const noexcept { return buffer_.capacity() == 0; }
+    size_t dequeue_many_(std::span<T> out) noexcept {
+        auto [pos, n] = claim_(head_, out.size(), 1);
+        for (size_t i = 0; i < n; i++) {
+            consume_(pos + i, [&](T &&value) { out[i] = std::move(value); });
+        }
+        return n;
+    }
+
+    // Claim up to max consecutive slots in the given state (0 for free, 1 for
+    // ready) from the position of counter, with a single CAS. Return the first
+    // claimed position and the number of claimed slots.
+    std::pair<size_t, size_t> claim_(Atomic<size_t> &counter, size_t max,
+                                     size_t state) noexcept {
+        auto mask = buffer_.capacity() - 1;
+        max = std::min(max, buffer_.capacity());
+        size_t pos = counter.load(std::memory_order_relaxed);
+        while (true) {
+            size_t n = 0;
+            intptr_t diff = 0;
+            while (n < max) {
+                Slot &slot = buffer_[(pos + n) & mask];
+                size_t seq = sequence_(slot).load(std::memory_order_seq_cst);
+                diff = static_cast<intptr_t>(seq - (lap_(pos + n) * 2 + state));
+                if (diff != 0) {
+                    break;
+                }
+                n++;
+            }
+            if (n == 0 && diff > 0) {
+                // Another thread claimed the slot, reload the position
+                pos = counter.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (n == 0) {
+                return {pos, 0}; // Full or empty
+            }
+            if (counter.compare_exchange_weak(pos, pos + n,
+                                              std::memory_order_relaxed)) {
+                return {pos, n};
+            }
+        }
+    }
 
-    bool empty_inner_() const noexcept { return size_inner_() == 0; }
+    template <typename U> void publish_(size_t pos, U &&item) noexcept {
+        Slot &slot = buffer_[pos & (buffer_.capacity() - 1)];
+        slot.storage.construct(std::forward<U>(item));
+        sequence_(slot).store(lap_(pos) * 2 + 1, std::memory_order_seq_cst);
+    }
+
+    template <typename Func> void consume_(size_t pos, Func &&func) noexcept {
+        Slot &slot = buffer_[pos & (buffer_.capacity() - 1)];
+        func(std::move(slot.storage.get()));
+        slot.storage.destroy();
+        sequence_(slot).store(lap_(pos) * 2 + 2, std::memory_order_seq_cst);
+    }
 
-    bool full_inner_() const noexcept {
-        return size_inner_() == buffer_.capacity();
+    size_t lap_(size_t pos) const noexcept {
+        return pos >> std::countr_zero(buffer_.capacity());
     }
 
     void push_close_inner_() noexcept {
-        if (closed_) {
+        if (closed_.load(std::memory_order_relaxed)) {
             return;
         }
-        closed_ = true;
+        closed_.store(true, std::memory_order_release);
         // Cancel all pending pop awaiters
         PopFinishHandleBase *pop_handle = nullptr;
         while ((pop_handle = pop_awaiters_.pop_front()) != nullptr) {
-            assert(empty_inner_());
+            awaiters_.fetch_sub(1, std::memory_order_relaxed);
+            if (!pop_handle->try_claim()) {
+                continue;
+            }
             pop_handle->set_result({-EPIPE, T()});
             pop_handle->schedule();
         }
         // Cancel all pending push awaiters
         PushFinishHandleBase *push_handle = nullptr;
         while ((push_handle = push_awaiters_.pop_front()) != nullptr) {
-            assert(full_inner_());
+            awaiters_.fetch_sub(1, std::memory_order_relaxed);
             push_handle->set_result(-EPIPE);
             push_handle->schedule();
         }
     }
 
     void destruct_all_() noexcept {
-        while (!empty_inner_()) {
-            pop_inner_();
+        while (dequeue_locked_().has_value()) {
         }
-        assert(head_ == tail_);
+        assert(head_.load() == tail_.load());
     }
 
-    size_t size_inner_() const noexcept { return tail_ - head_; }
-
 private:
+    struct Slot {
+        size_t sequence;
+        RawStorage<T> storage;
+    };
+
+    static AtomicRef<size_t> sequence_(Slot &slot) noexcept {
+        return AtomicRef<size_t>(slot.sequence);
+    }
+
     template <typename Handle>
     using HandleList = IntrusiveDoubleList<Handle, &Handle::link_entry_>;
 
-    mutable std::mutex mutex_;
+    Mutex mutex_;
     HandleList<PushFinishHandleBase> push_awaiters_;
     HandleList<PopFinishHandleBase> pop_awaiters_;
-    size_t head_ = 0;
-    size_t tail_ = 0;
-    SmallArray<RawStorage<T>, N> buffer_;
-    bool closed_ = false;
+    // Item put back at the head of the buffer
+    std::optional<T> front_;
+    // Number of awaiting operations, including those being registered, plus
+    // one while front_ holds an item
+    Atomic<size_t> awaiters_ = 0;
+    Atomic<bool> closed_ = false;
+    alignas(cache_line_size) Atomic<size_t> head_ = 0;
+    alignas(cache_line_size) Atomic<size_t> tail_ = 0;
+    alignas(cache_line_size) SmallArray<Slot, N> buffer_;
 };
 
-template <typename T, size_t N>
-class Channel<T, N>::PushFinishHandleBase : public WorkInvoker {
+template <typename T, size_t N, typename Policy>
+class ChannelImpl<T, N, Policy>::PushFinishHandleBase : public WorkInvoker {
 public:
-    PushFinishHandleBase(T &item) : item_(item) {}
+    PushFinishHandleBase(T *item) : item_(item) {}
 
     void schedule() noexcept {
         if (runtime_ == nullptr) [[unlikely]] {
@@ -369,11 +807,11 @@ public:
             auto *this_fake = static_cast<FakePushFinishHandle *>(this);
             delete this_fake;
         } else {
-            runtime_->schedule(this);
+            Policy::schedule(runtime_, this);
         }
     }
 
-    T &get_item() noexcept { return item_; }
+    T &get_item() noexcept { return *item_; }
 
     void set_result(int32_t result) noexcept { result_ = result; }
 
@@ -382,23 +820,24 @@ public:
 
 public:
     Runtime *runtime_ = nullptr;
-    T &item_;
+    T *item_;
     int32_t result_ = -ENOTRECOVERABLE; // Internal error if not set
 };
 
-template <typename T, size_t N>
+template <typename T, size_t N, typename Policy>
 template <typename Receiver>
-class Channel<T, N>::PushFinishHandle
+class ChannelImpl<T, N, Policy>::PushFinishHandle
     : public InvokerAdapter<PushFinishHandle<Receiver>, PushFinishHandleBase> {
 public:
     using Base =
         InvokerAdapter<PushFinishHandle<Receiver>, PushFinishHandleBase>;
 
-    PushFinishHandle(Channel &channel, T &item, Receiver receiver)
-        : Base(item), channel_(channel), receiver_(std::move(receiver)) {}
+    PushFinishHandle(ChannelImpl &channel, T &item, Receiver receiver)
+        : Base(&item), channel_(channel), receiver_(std::move(receiver)) {}
 
     void start(Runtime *runtime) noexcept {
         this->runtime_ = runtime;
+        this->set_priority(detail::Context::current().priority());
         int32_t r = channel_.request_push_(this);
         if (r != -EAGAIN) {
             std::move(receiver_)(r);
@@ -425,7 +864,7 @@ private:
             assert(this->result_ == -ENOTRECOVERABLE);
             this->result_ = -ECANCELED;
             assert(this->runtime_ != nullptr);
-            this->runtime_->schedule(this);
+            Policy::schedule(this->runtime_, this);
         }
     }
 
@@ -438,52 +877,73 @@ private:
         stop_callback_t<stop_token_t<Receiver>, Cancellation>;
 
 private:
-    Channel &channel_;
+    ChannelImpl &channel_;
     Receiver receiver_;
     std::optional<StopCallbackType> stop_callback_;
 };
 
-template <typename T, size_t N>
-class Channel<T, N>::FakePushFinishHandle : public PushFinishHandleBase {
+template <typename T, size_t N, typename Policy>
+class ChannelImpl<T, N, Policy>::FakePushFinishHandle
+    : public PushFinishHandleBase {
 public:
     FakePushFinishHandle(T &&item)
-        : PushFinishHandleBase(item_copy_), item_copy_(std::move(item)) {}
+        : PushFinishHandleBase(&item_copy_), item_copy_(std::move(item)) {}
 
 private:
     T item_copy_;
 };
 
-template <typename T, size_t N>
-class Channel<T, N>::PopFinishHandleBase : public WorkInvoker {
+template <typename T, size_t N, typename Policy>
+class ChannelImpl<T, N, Policy>::PopFinishHandleBase : public WorkInvoker {
 public:
     void schedule() noexcept {
         assert(runtime_ != nullptr);
-        runtime_->schedule(this);
+        Policy::schedule(runtime_, this);
     }
 
     void set_result(std::pair<int32_t, T> result) noexcept {
         result_ = std::move(result);
     }
 
+    // Awaiting pops of a select share one claim flag, and only the first
+    // channel to claim it may complete the select. The channels unlink the
+    // handles they fail to claim, and mark them as dropped so that the select
+    // does not need to take their lock to remove them again.
+    bool try_claim() noexcept {
+        if (claim_flag_ == nullptr ||
+            !claim_flag_->exchange(true, std::memory_order_acq_rel)) {
+            return true;
+        }
+        dropped_.store(true, std::memory_order_release);
+        return false;
+    }
+
+    bool dropped() const noexcept {
+        return dropped_.load(std::memory_order_acquire);
+    }
+
 public:
     DoubleLinkEntry link_entry_;
 
 protected:
     Runtime *runtime_ = nullptr;
+    std::atomic_bool *claim_flag_ = nullptr;
+    Atomic<bool> dropped_ = false;
     // Internal error if not set
     std::pair<int32_t, T> result_ = {-ENOTRECOVERABLE, T()};
 };
 
-template <typename T, size_t N>
+template <typename T, size_t N, typename Policy>
 template <typename Receiver>
-class Channel<T, N>::PopFinishHandle
+class ChannelImpl<T, N, Policy>::PopFinishHandle
     : public InvokerAdapter<PopFinishHandle<Receiver>, PopFinishHandleBase> {
 public:
-    PopFinishHandle(Channel &channel, Receiver receiver)
+    PopFinishHandle(ChannelImpl &channel, Receiver receiver)
         : channel_(channel), receiver_(std::move(receiver)) {}
 
     void start(Runtime *runtime) noexcept {
         this->runtime_ = runtime;
+        this->set_priority(detail::Context::current().priority());
         auto item = channel_.request_pop_(this);
         auto r = item.first;
         if (r != -EAGAIN) {
@@ -511,7 +971,7 @@ private:
             assert(this->result_.first == -ENOTRECOVERABLE);
             this->result_.first = -ECANCELED;
             assert(this->runtime_ != nullptr);
-            this->runtime_->schedule(this);
+            Policy::schedule(this->runtime_, this);
         }
     }
 
@@ -524,16 +984,148 @@ private:
         stop_callback_t<stop_token_t<Receiver>, Cancellation>;
 
 private:
-    Channel &channel_;
+    ChannelImpl &channel_;
+    Receiver receiver_;
+    std::optional<StopCallbackType> stop_callback_;
+};
+
+template <typename T, size_t N, typename Policy>
+template <typename Receiver>
+class ChannelImpl<T, N, Policy>::PushManyFinishHandle
+    : public InvokerAdapter<PushManyFinishHandle<Receiver>,
+                            PushFinishHandleBase> {
+public:
+    using Base =
+        InvokerAdapter<PushManyFinishHandle<Receiver>, PushFinishHandleBase>;
+
+    PushManyFinishHandle(ChannelImpl &channel, std::span<T> items,
+                         Receiver receiver)
+        : Base(items.data()), channel_(channel), items_(items),
+          receiver_(std::move(receiver)) {}
+
+    void start(Runtime *runtime) noexcept {
+        this->runtime_ = runtime;
+        this->set_priority(detail::Context::current().priority());
+        int32_t r = channel_.request_push_many_(this, items_);
+        if (r != -EAGAIN) {
+            std::move(receiver_)(r);
+            return;
+        }
+
+        auto stop_token = receiver_.get_stop_token();
+        if (stop_token.stop_possible()) {
+            stop_callback_.emplace(std::move(stop_token), Cancellation{this});
+        }
+    }
+
+    void invoke() noexcept {
+        stop_callback_.reset();
+        assert(this->runtime_ != nullptr);
+        this->runtime_->resume_work();
+        int32_t r = this->result_;
+        if (r == 0) {
+            // The first item is pushed, push the rest without awaiting
+            r = 1 + std::max(channel_.try_push_many(items_.subspan(1)), 0);
+        }
+        std::move(receiver_)(r);
+    }
+
+private:
+    void cancel_() noexcept {
+        if (channel_.cancel_push_(this)) {
+            // Successfully canceled
+            assert(this->result_ == -ENOTRECOVERABLE);
+            this->result_ = -ECANCELED;
+            assert(this->runtime_ != nullptr);
+            Policy::schedule(this->runtime_, this);
+        }
+    }
+
+    struct Cancellation {
+        PushManyFinishHandle *self;
+        void operator()() noexcept { self->cancel_(); }
+    };
+
+    using StopCallbackType =
+        stop_callback_t<stop_token_t<Receiver>, Cancellation>;
+
+private:
+    ChannelImpl &channel_;
+    std::span<T> items_;
+    Receiver receiver_;
+    std::optional<StopCallbackType> stop_callback_;
+};
+
+template <typename T, size_t N, typename Policy>
+template <typename Receiver>
+class ChannelImpl<T, N, Policy>::PopManyFinishHandle
+    : public InvokerAdapter<PopManyFinishHandle<Receiver>,
+                            PopFinishHandleBase> {
+public:
+    PopManyFinishHandle(ChannelImpl &channel, std::span<T> out,
+                        Receiver receiver)
+        : channel_(channel), out_(out), receiver_(std::move(receiver)) {}
+
+    void start(Runtime *runtime) noexcept {
+        this->runtime_ = runtime;
+        this->set_priority(detail::Context::current().priority());
+        int32_t r = channel_.request_pop_many_(this, out_);
+        if (r != -EAGAIN) {
+            std::move(receiver_)(r);
+            return;
+        }
+
+        auto stop_token = receiver_.get_stop_token();
+        if (stop_token.stop_possible()) {
+            stop_callback_.emplace(std::move(stop_token), Cancellation{this});
+        }
+    }
+
+    void invoke() noexcept {
+        stop_callback_.reset();
+        assert(this->runtime_ != nullptr);
+        this->runtime_->resume_work();
+        int32_t r = this->result_.first;
+        if (r == 0) {
+            // The first item is popped, pop the rest without awaiting
+            out_[0] = std::move(this->result_.second);
+            r = 1 + std::max(channel_.try_pop_many(out_.subspan(1)), 0);
+        }
+        std::move(receiver_)(r);
+    }
+
+private:
+    void cancel_() noexcept {
+        if (channel_.cancel_pop_(this)) {
+            // Successfully canceled
+            assert(this->result_.first == -ENOTRECOVERABLE);
+            this->result_.first = -ECANCELED;
+            assert(this->runtime_ != nullptr);
+            Policy::schedule(this->runtime_, this);
+        }
+    }
+
+    struct Cancellation {
+        PopManyFinishHandle *self;
+        void operator()() noexcept { self->cancel_(); }
+    };
+
+    using StopCallbackType =
+        stop_callback_t<stop_token_t<Receiver>, Cancellation>;
+
+private:
+    ChannelImpl &channel_;
+    std::span<T> out_;
     Receiver receiver_;
     std::optional<StopCallbackType> stop_callback_;
 };
 
-template <typename T, size_t N> class Channel<T, N>::MovePushSender {
+template <typename T, size_t N, typename Policy>
+class ChannelImpl<T, N, Policy>::MovePushSender {
 public:
     using ReturnType = int32_t;
 
-    MovePushSender(Channel &channel, T &&item)
+    MovePushSender(ChannelImpl &channel, T &&item)
         : channel_(channel), item_(std::move(item)) {}
 
     template <typename Receiver> auto connect(Receiver receiver) noexcept {
@@ -544,11 +1136,10 @@ public:
 private:
     template <typename Receiver>
     class OperationState
-        : public Channel<T, N>::template PushFinishHandle<Receiver> {
+        : public ChannelImpl::template PushFinishHandle<Receiver> {
     public:
-        using Base =
-            typename Channel<T, N>::template PushFinishHandle<Receiver>;
-        OperationState(Channel &channel, T &&item, Receiver receiver)
+        using Base = typename ChannelImpl::template PushFinishHandle<Receiver>;
+        OperationState(ChannelImpl &channel, T &&item, Receiver receiver)
             : Base(channel, item, std::move(receiver)) {}
 
         void start(unsigned int /*flags*/) noexcept {
@@ -557,15 +1148,16 @@ private:
         }
     };
 
-    Channel &channel_;
+    ChannelImpl &channel_;
     T &&item_;
 };
 
-template <typename T, size_t N> class Channel<T, N>::CopyPushSender {
+template <typename T, size_t N, typename Policy>
+class ChannelImpl<T, N, Policy>::CopyPushSender {
 public:
     using ReturnType = int32_t;
 
-    CopyPushSender(Channel &channel, const T &item)
+    CopyPushSender(ChannelImpl &channel, const T &item)
         : channel_(channel), item_(item) {}
 
     template <typename Receiver> auto connect(Receiver receiver) noexcept {
@@ -575,11 +1167,10 @@ public:
 private:
     template <typename Receiver>
     class OperationState
-        : public Channel<T, N>::template PushFinishHandle<Receiver> {
+        : public ChannelImpl::template PushFinishHandle<Receiver> {
     public:
-        using Base =
-            typename Channel<T, N>::template PushFinishHandle<Receiver>;
-        OperationState(Channel &channel, const T &item, Receiver receiver)
+        using Base = typename ChannelImpl::template PushFinishHandle<Receiver>;
+        OperationState(ChannelImpl &channel, const T &item, Receiver receiver)
             : Base(channel, item_copy_, std::move(receiver)), item_copy_(item) {
         }
 
@@ -592,15 +1183,16 @@ private:
         T item_copy_;
     };
 
-    Channel &channel_;
+    ChannelImpl &channel_;
     const T &item_;
 };
 
-template <typename T, size_t N> class Channel<T, N>::PopSender {
+template <typename T, size_t N, typename Policy>
+class ChannelImpl<T, N, Policy>::PopSender {
 public:
     using ReturnType = std::pair<int32_t, T>;
 
-    PopSender(Channel &channel) : channel_(channel) {}
+    PopSender(ChannelImpl &channel) : channel_(channel) {}
 
     template <typename Receiver> auto connect(Receiver receiver) noexcept {
         return OperationState<Receiver>(channel_, std::move(receiver));
@@ -609,9 +1201,9 @@ public:
 private:
     template <typename Receiver>
     class OperationState
-        : public Channel<T, N>::template PopFinishHandle<Receiver> {
+        : public ChannelImpl::template PopFinishHandle<Receiver> {
     public:
-        using Base = typename Channel<T, N>::template PopFinishHandle<Receiver>;
+        using Base = typename ChannelImpl::template PopFinishHandle<Receiver>;
         using Base::Base;
 
         void start(unsigned int /*flags*/) noexcept {
@@ -620,7 +1212,94 @@ private:
         }
     };
 
-    Channel &channel_;
+    ChannelImpl &channel_;
+};
+
+template <typename T, size_t N, typename Policy>
+class ChannelImpl<T, N, Policy>::PushManySender {
+public:
+    using ReturnType = int32_t;
+
+    PushManySender(ChannelImpl &channel, std::span<T> items)
+        : channel_(channel), items_(items) {}
+
+    template <typename Receiver> auto connect(Receiver receiver) noexcept {
+        return OperationState<Receiver>(channel_, items_, std::move(receiver));
+    }
+
+private:
+    template <typename Receiver>
+    class OperationState
+        : public ChannelImpl::template PushManyFinishHandle<Receiver> {
+    public:
+        using Base =
+            typename ChannelImpl::template PushManyFinishHandle<Receiver>;
+        using Base::Base;
+
+        void start(unsigned int /*flags*/) noexcept {
+            auto *runtime = detail::Context::current().runtime();
+            Base::start(runtime);
+        }
+    };
+
+    ChannelImpl &channel_;
+    std::span<T> items_;
+};
+
+template <typename T, size_t N, typename Policy>
+class ChannelImpl<T, N, Policy>::PopManySender {
+public:
+    using ReturnType = int32_t;
+
+    PopManySender(ChannelImpl &channel, std::span<T> out)
+        : channel_(channel), out_(out) {}
+
+    template <typename Receiver> auto connect(Receiver receiver) noexcept {
+        return OperationState<Receiver>(channel_, out_, std::move(receiver));
+    }
+
+private:
+    template <typename Receiver>
+    class OperationState
+        : public ChannelImpl::template PopManyFinishHandle<Receiver> {
+    public:
+        using Base =
+            typename ChannelImpl::template PopManyFinishHandle<Receiver>;
+        using Base::Base;
+
+        void start(unsigned int /*flags*/) noexcept {
+            auto *runtime = detail::Context::current().runtime();
+            Base::start(runtime);
+        }
+    };
+
+    ChannelImpl &channel_;
+    std::span<T> out_;
+};
+
+} // namespace detail
+
+/**
+ * @brief Thread-safe bounded channel for communication and synchronization.
+ * @tparam T Type of the items transmitted through the channel.
+ * @tparam N When the capacity is less than or equal to N, the channel uses
+ * stack storage for buffering; otherwise, it uses heap storage.
+ * @details This class provides a thread-safe channel for communication and
+ * synchronization for both intra-Runtime and inter-Runtime scenarios. It
+ * supports both buffered and unbuffered modes, as well as push and pop
+ * operations that can be awaited in coroutines. The internal implementation
+ * utilizes msg_ring operations of io_uring for efficient cross-runtime
+ * notifications.
+ *
+ * The buffer is a lock-free bounded MPMC ring buffer. While no operation is
+ * awaiting, pushing to a non-full channel and popping from a non-empty channel
+ * never take the internal lock. The lock is only used to register and wake
+ * awaiting operations.
+ */
+template <typename T, size_t N = 2>
+class Channel : public detail::ChannelImpl<T, N, detail::SharedChannelPolicy> {
+public:
+    using detail::ChannelImpl<T, N, detail::SharedChannelPolicy>::ChannelImpl;
 };
 
 } // namespace condy
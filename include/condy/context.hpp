@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "condy/priority.hpp"
 #include "condy/singleton.hpp"
 #include "condy/utils.hpp"
 #include <cassert>
@@ -16,16 +17,23 @@ class Runtime;
 
 namespace detail {
 
+class BlockCache;
+
 class Context : public ThreadLocalSingleton<Context> {
 public:
-    void init(Ring *ring, Runtime *runtime) noexcept {
+    void init(Ring *ring, Runtime *runtime,
+              BlockCache *block_cache = nullptr) noexcept {
         ring_ = ring;
         runtime_ = runtime;
+        block_cache_ = block_cache;
+        priority_ = TaskPriority::Normal;
         bgid_pool_.reset();
     }
     void reset() noexcept {
         ring_ = nullptr;
         runtime_ = nullptr;
+        block_cache_ = nullptr;
+        priority_ = TaskPriority::Normal;
         bgid_pool_.reset();
     }
 
@@ -33,6 +41,13 @@ public:
 
     Runtime *runtime() noexcept { return runtime_; }
 
+    BlockCache *block_cache() noexcept { return block_cache_; }
+
+    // Priority of the running task
+    TaskPriority priority() const noexcept { return priority_; }
+
+    void set_priority(TaskPriority priority) noexcept { priority_ = priority; }
+
     uint16_t next_bgid() { return bgid_pool_.allocate(); }
 
     void recycle_bgid(uint16_t bgid) noexcept { bgid_pool_.recycle(bgid); }
@@ -40,6 +55,8 @@ public:
 private:
     Ring *ring_ = nullptr;
     Runtime *runtime_ = nullptr;
+    BlockCache *block_cache_ = nullptr;
+    TaskPriority priority_ = TaskPriority::Normal;
     IdPool<uint16_t> bgid_pool_;
 };
 
@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include "condy/block_cache.hpp"
 #include "condy/coro.hpp"
 #include "condy/invoker.hpp"
 #include "condy/sender_operations.hpp"
@@ -80,7 +81,17 @@ private:
 };
 
 template <typename Promise>
-class BindAllocator<Promise, void> : public Promise {};
+class BindAllocator<Promise, void> : public Promise {
+public:
+    // Recycle frames with the block cache of the current runtime
+    static void *operator new(size_t size) {
+        return detail::BlockCache::allocate(size);
+    }
+
+    void operator delete(void *ptr) noexcept {
+        detail::BlockCache::deallocate(ptr);
+    }
+};
 
 template <typename Coro>
 class PromiseBase : public InvokerAdapter<PromiseBase<Coro>, WorkInvoker> {
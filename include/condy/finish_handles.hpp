@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "condy/block_cache.hpp"
 #include "condy/concepts.hpp"
 #include "condy/runtime.hpp"
 #include "condy/type_traits.hpp"
@@ -116,6 +117,18 @@ public:
         this->handle_func_ = handle_static_;
     }
 
+    // The handle outlives the awaiting operation until the notification CQE
+    // arrives, recycle it with the block cache of the current runtime.
+    static void *operator new(size_t size) {
+        static_assert(alignof(ZeroCopyOpFinishHandle) <=
+                      __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+        return detail::BlockCache::allocate(size);
+    }
+
+    void operator delete(void *ptr) noexcept {
+        detail::BlockCache::deallocate(ptr);
+    }
+
 private:
     static bool handle_static_(void *data, io_uring_cqe *cqe) noexcept {
         auto *self = static_cast<ZeroCopyOpFinishHandle *>(data);
@@ -6,12 +6,14 @@
 
 #pragma once
 
-#include "condy/intrusive.hpp"
+#include "condy/context.hpp"
 #include "condy/invoker.hpp"
+#include "condy/parking_lot.hpp"
 #include "condy/runtime.hpp"
 #include "condy/type_traits.hpp"
 #include <atomic>
 #include <cerrno>
+#include <cstdint>
 #include <optional>
 
 namespace condy {
@@ -23,6 +25,12 @@ namespace condy {
  * coroutines to wait on a futex value and be efficiently notified when the
  * value changes. This class is different from condy::async_futex_wait(), the
  * latter one can be used together with thread-based synchronous wait.
+ *
+ * A Futex is only a reference to the atomic variable. Awaiting coroutines are
+ * parked in a global table sharded by the address of the atomic variable, so
+ * it costs no lock or wait list per object. The Futex object itself can be
+ * destroyed while coroutines are waiting, but the atomic variable must outlive
+ * all of them.
  * @tparam T Type of the futex value.
  */
 template <typename T> class Futex {
@@ -33,8 +41,6 @@ public:
      */
     Futex(std::atomic<T> &futex) : futex_(futex) {}
 
-    ~Futex() { notify_all_(-EIDRM); }
-
     Futex(const Futex &) = delete;
     Futex &operator=(const Futex &) = delete;
     Futex(Futex &&) = delete;
@@ -49,93 +55,35 @@ public:
      * will not be suspended.
      * @param old The old value to compare with the futex value.
      * @return int32_t 0 if the wait operation is successful; -ECANCELED if the
-     * wait operation is canceled while waiting; -EIDRM if the futex is
-     * destroyed while waiting (usually indicates a lifetime management bug).
+     * wait operation is canceled while waiting.
      */
-    WaitSender wait(T old) noexcept { return {*this, old}; }
+    WaitSender wait(T old) noexcept { return {futex_, old}; }
 
     /**
      * @brief Notify one awaiting coroutine, if any.
      * @note This function is thread-safe and can be called from any thread.
      */
-    void notify_one() noexcept {
-        WaitFinishHandleBase *handle = nullptr;
-        {
-            std::lock_guard<std::mutex> lock(mutex_);
-            handle = wait_awaiters_.pop_front();
-        }
-        if (handle) {
-            handle->set_result(0);
-            handle->schedule();
-        }
-    }
+    void notify_one() noexcept { notify_(1); }
 
     /**
      * @brief Notify all awaiting coroutines.
      * @note This function is thread-safe and can be called from any thread.
      */
-    void notify_all() noexcept { notify_all_(0); }
+    void notify_all() noexcept { notify_(SIZE_MAX); }
 
 private:
-    class WaitFinishHandleBase;
+    using WaitFinishHandleBase = detail::ParkingHandle;
     template <typename Receiver> class WaitFinishHandle;
 
-    bool cancel_wait_(WaitFinishHandleBase *handle) noexcept {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return wait_awaiters_.remove(handle);
-    }
-
-    int32_t request_wait_(WaitFinishHandleBase *handle, T old) noexcept {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto val = futex_.load(std::memory_order_relaxed);
-        if (val != old) {
-            return 0; // No need to wait
-        }
-        wait_awaiters_.push_back(handle);
-        detail::Context::current().runtime()->pend_work();
-        return -EAGAIN; // Need to wait
-    }
-
 private:
-    void notify_all_(int32_t result) noexcept {
-        HandleList handles;
-        {
-            std::lock_guard<std::mutex> lock(mutex_);
-            handles = std::move(wait_awaiters_);
-        }
-        while (auto *handle = handles.pop_front()) {
-            handle->set_result(result);
-            handle->schedule();
-        }
+    void notify_(size_t max) noexcept {
+        detail::ParkingLot::instance().unpark(&futex_, max, 0);
     }
 
 private:
-    using HandleList = IntrusiveDoubleList<WaitFinishHandleBase,
-                                           &WaitFinishHandleBase::link_entry_>;
-
-    mutable std::mutex mutex_;
-    HandleList wait_awaiters_;
     std::atomic<T> &futex_;
 };
 
-template <typename T>
-class Futex<T>::WaitFinishHandleBase : public WorkInvoker {
-public:
-    void schedule() noexcept {
-        assert(runtime_ != nullptr);
-        runtime_->schedule(this);
-    }
-
-    void set_result(int32_t result) noexcept { result_ = result; }
-
-public:
-    DoubleLinkEntry link_entry_;
-
-protected:
-    Runtime *runtime_ = nullptr;
-    int32_t result_ = -ENOTRECOVERABLE; // Internal error if not set
-};
-
 template <typename T>
 template <typename Receiver>
 class Futex<T>::WaitFinishHandle
@@ -143,16 +91,19 @@ class Futex<T>::WaitFinishHandle
 public:
     using Base = InvokerAdapter<WaitFinishHandle, WaitFinishHandleBase>;
 
-    WaitFinishHandle(Futex &futex, Receiver receiver)
+    WaitFinishHandle(std::atomic<T> &futex, Receiver receiver)
         : futex_(futex), receiver_(std::move(receiver)) {}
 
     void start(Runtime *runtime, T old) noexcept {
         this->runtime_ = runtime;
-        int32_t r = futex_.request_wait_(this, old);
-        if (r != -EAGAIN) {
-            std::move(receiver_)(r);
+        this->set_priority(detail::Context::current().priority());
+        if (!detail::ParkingLot::instance().park(&futex_, this, [&]() {
+                return futex_.load(std::memory_order_relaxed) == old;
+            })) {
+            std::move(receiver_)(0); // No need to wait
             return;
         }
+        runtime->pend_work();
 
         auto stop_token = receiver_.get_stop_token();
         if (stop_token.stop_possible()) {
@@ -169,7 +120,8 @@ public:
 
 private:
     void cancel_() noexcept {
-        if (futex_.cancel_wait_(this)) {
+        // Cancel by the parked key, without touching the atomic variable
+        if (detail::ParkingLot::instance().cancel(this->key_, this)) {
             // Successfully canceled
             this->result_ = -ECANCELED;
             assert(this->runtime_ != nullptr);
@@ -186,7 +138,9 @@ private:
         stop_callback_t<stop_token_t<Receiver>, Cancellation>;
 
 private:
-    Futex &futex_;
+    // Refers to the atomic variable rather than the Futex, which may be
+    // destroyed while waiting
+    std::atomic<T> &futex_;
     Receiver receiver_;
     std::optional<StopCallbackType> stop_callback_;
 };
@@ -195,7 +149,7 @@ template <typename T> struct Futex<T>::WaitSender {
 public:
     using ReturnType = int32_t;
 
-    WaitSender(Futex &futex, T old) : futex_(futex), old_(old) {}
+    WaitSender(std::atomic<T> &futex, T old) : futex_(futex), old_(old) {}
 
     template <typename Receiver> auto connect(Receiver receiver) noexcept {
         return OperationState<Receiver>(futex_, old_, std::move(receiver));
@@ -206,7 +160,7 @@ private:
     class OperationState : public WaitFinishHandle<Receiver> {
     public:
         using Base = WaitFinishHandle<Receiver>;
-        OperationState(Futex &futex, T old, Receiver receiver)
+        OperationState(std::atomic<T> &futex, T old, Receiver receiver)
             : Base(futex, std::move(receiver)), old_(old) {}
 
         void start(unsigned int /*flags*/) noexcept {
@@ -219,7 +173,7 @@ private:
     };
 
 private:
-    Futex &futex_;
+    std::atomic<T> &futex_;
     T old_;
 };
 
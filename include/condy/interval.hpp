@@ -0,0 +1,341 @@
+/**
+ * @file interval.hpp
+ * @brief Periodic timer backed by a multishot timeout.
+ * @details This file defines condy::Interval, which ticks periodically for
+ * its whole lifetime with a single multishot timeout submitted to the kernel,
+ * instead of a new timeout for each tick.
+ */
+
+#pragma once
+
+#include "condy/condy_uring.hpp"
+#include "condy/context.hpp"
+#include "condy/invoker.hpp"
+#include "condy/runtime.hpp"
+#include "condy/type_traits.hpp"
+#include "condy/work_type.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <utility>
+
+#if !IO_URING_CHECK_VERSION(2, 4) // >= 2.4
+
+namespace condy {
+
+/**
+ * @brief Behavior of condy::Interval when ticks are missed because the
+ * consumer is late.
+ */
+enum class MissedTickPolicy : uint8_t {
+    /// Return the missed ticks back-to-back until catching up
+    Burst,
+    /// Drop the missed ticks, the next tick keeps the original schedule
+    Skip,
+    /// Drop the missed ticks, and restart the period from the late tick
+    Delay,
+};
+
+namespace detail {
+
+class TickWaiterBase : public WorkInvoker {
+public:
+    void schedule(int32_t result) noexcept {
+        assert(runtime_ != nullptr);
+        result_ = result;
+        runtime_->schedule_local(this);
+    }
+
+protected:
+    Runtime *runtime_ = nullptr;
+    int32_t result_ = -ENOTRECOVERABLE; // Internal error if not set
+};
+
+// Outlives the Interval until the final CQE of the multishot timeout arrives
+class IntervalHandle : public OpFinishHandleBase {
+public:
+    IntervalHandle(std::chrono::nanoseconds period, MissedTickPolicy policy)
+        : policy_(policy) {
+        auto secs = std::chrono::floor<std::chrono::seconds>(period);
+        ts_.tv_sec = secs.count();
+        ts_.tv_nsec = (period - secs).count();
+        this->handle_func_ = handle_static_;
+    }
+
+    // Must be called in the runtime thread. Return the number of missed ticks
+    // if a tick is ready, otherwise register the waiter and return -EAGAIN.
+    int32_t request_tick(Runtime *runtime, TickWaiterBase *waiter) noexcept {
+        if (runtime_ == nullptr) {
+            runtime_ = runtime;
+        }
+        assert(runtime_ == runtime && "Interval is bound to one runtime");
+        if (!armed_) {
+            arm_();
+        }
+        if (expired_ > consumed_) {
+            return consume_tick();
+        }
+        assert(waiter_ == nullptr && "Only one tick can be awaited at a time");
+        waiter_ = waiter;
+        return -EAGAIN;
+    }
+
+    // Must be called in the runtime thread.
+    bool cancel_tick(TickWaiterBase *waiter) noexcept {
+        if (waiter_ != waiter) {
+            return false;
+        }
+        waiter_ = nullptr;
+        return true;
+    }
+
+    // Must be called in the runtime thread. Return the number of missed ticks
+    // and consume the ready ticks according to the policy.
+    int32_t consume_tick() noexcept {
+        assert(expired_ > consumed_);
+        uint64_t missed = expired_ - consumed_ - 1;
+        if (policy_ == MissedTickPolicy::Burst) {
+            consumed_++;
+        } else {
+            consumed_ = expired_;
+            if (policy_ == MissedTickPolicy::Delay && missed > 0 && armed_) {
+                rearm_();
+            }
+        }
+        return static_cast<int32_t>(std::min<uint64_t>(
+            missed, std::numeric_limits<int32_t>::max()));
+    }
+
+    // The handle deletes itself once the timeout is removed.
+    void destroy() noexcept {
+        assert(waiter_ == nullptr);
+        if (!armed_) {
+            delete this;
+            return;
+        }
+        orphaned_ = true;
+        runtime_->cancel(encode_work(this, WorkType::Common));
+    }
+
+private:
+    static bool handle_static_(void *data, io_uring_cqe *cqe) noexcept {
+        auto *self = static_cast<IntervalHandle *>(data);
+        return self->handle_impl_(cqe);
+    }
+
+    bool handle_impl_(io_uring_cqe *cqe) noexcept {
+        bool more = cqe->flags & IORING_CQE_F_MORE;
+        if (cqe->res == -ETIME) {
+            expired_++;
+        }
+        if (!more) {
+            armed_ = false;
+            if (orphaned_) {
+                delete this;
+                return true;
+            }
+        }
+        if (waiter_ != nullptr) {
+            if (expired_ > consumed_) {
+                // Consumed when the waiter runs, after the other CQEs of the
+                // same batch are counted.
+                std::exchange(waiter_, nullptr)->schedule(-EAGAIN);
+            } else if (!more) {
+                // Stopped without a tick, e.g. cancelled by others
+                std::exchange(waiter_, nullptr)->schedule(cqe->res);
+            }
+        }
+        return !more;
+    }
+
+    void arm_() noexcept {
+        io_uring_sqe *sqe = detail::Context::current().ring()->get_sqe();
+        io_uring_prep_timeout(sqe, &ts_, 0, IORING_TIMEOUT_MULTISHOT);
+        io_uring_sqe_set_data64(sqe, encode_work(this, WorkType::Common));
+        runtime_->pend_work();
+        armed_ = true;
+    }
+
+    // Restart the period from now
+    void rearm_() noexcept {
+        io_uring_sqe *sqe = detail::Context::current().ring()->get_sqe();
+        io_uring_prep_timeout_update(sqe, &ts_,
+                                     encode_work(this, WorkType::Common), 0);
+        io_uring_sqe_set_data64(sqe, encode_work(nullptr, WorkType::Ignore));
+        io_uring_sqe_set_flags(sqe, IOSQE_CQE_SKIP_SUCCESS);
+    }
+
+private:
+    Runtime *runtime_ = nullptr;
+    TickWaiterBase *waiter_ = nullptr;
+    __kernel_timespec ts_ = {};
+    uint64_t expired_ = 0;
+    uint64_t consumed_ = 0;
+    MissedTickPolicy policy_;
+    bool armed_ = false;
+    bool orphaned_ = false;
+};
+
+} // namespace detail
+
+/**
+ * @brief Periodic timer.
+ * @details The interval submits a multishot timeout on the first call to
+ * tick(), which then fires every period until the interval is destroyed, so
+ * a periodic task costs a single SQE for its lifetime. Ticks fired while
+ * nobody awaits are kept, and handled according to the MissedTickPolicy once
+ * the consumer comes back.
+ *
+ * An interval is bound to the runtime it first ticks in, and must be used and
+ * destroyed in that runtime. A pending tick can still be cancelled from other
+ * threads.
+ */
+class Interval {
+public:
+    /**
+     * @brief Construct a new Interval object
+     * @param period The period of ticks.
+     * @param policy The behavior when ticks are missed.
+     */
+    template <typename Rep, typename Period>
+    Interval(std::chrono::duration<Rep, Period> period,
+             MissedTickPolicy policy = MissedTickPolicy::Burst)
+        : handle_(new detail::IntervalHandle(
+              std::chrono::ceil<std::chrono::nanoseconds>(period), policy)) {}
+
+    ~Interval() { handle_->destroy(); }
+
+    Interval(const Interval &) = delete;
+    Interval &operator=(const Interval &) = delete;
+    Interval(Interval &&) = delete;
+    Interval &operator=(Interval &&) = delete;
+
+public:
+    class [[nodiscard]] TickSender;
+    /**
+     * @brief Wait for the next tick.
+     * @details The first tick completes one period after the first call. Only
+     * one tick can be awaited at a time.
+     * @return int32_t The number of ticks missed right before this one, which
+     * are returned later with MissedTickPolicy::Burst, and dropped otherwise;
+     * -ECANCELED if the wait is cancelled; or other negative errors of the
+     * timeout.
+     */
+    TickSender tick() noexcept;
+
+private:
+    template <typename Receiver> class TickFinishHandle;
+
+    detail::IntervalHandle *handle_;
+};
+
+template <typename Receiver>
+class Interval::TickFinishHandle
+    : public InvokerAdapter<TickFinishHandle<Receiver>,
+                            detail::TickWaiterBase> {
+public:
+    TickFinishHandle(detail::IntervalHandle *handle, Receiver receiver)
+        : handle_(handle), receiver_(std::move(receiver)) {}
+
+    void start(Runtime *runtime) noexcept {
+        this->runtime_ = runtime;
+        this->set_priority(detail::Context::current().priority());
+        int32_t r = handle_->request_tick(runtime, this);
+        if (r != -EAGAIN) {
+            std::move(receiver_)(r);
+            return;
+        }
+        runtime->pend_work();
+
+        auto stop_token = receiver_.get_stop_token();
+        if (stop_token.stop_possible()) {
+            stop_callback_.emplace(std::move(stop_token), Cancellation{this});
+        }
+    }
+
+    void invoke() noexcept {
+        stop_callback_.reset();
+        if (forwarded_cancel_.ready()) {
+            finish_();
+        }
+    }
+
+private:
+    friend class detail::ForwardedCancellation<TickFinishHandle>;
+
+    void finish_() noexcept {
+        assert(this->runtime_ != nullptr);
+        this->runtime_->resume_work();
+        int32_t r = this->result_;
+        if (r == -EAGAIN) {
+            r = handle_->consume_tick();
+        }
+        std::move(receiver_)(r);
+    }
+
+    void cancel_() noexcept {
+        // The interval belongs to the runtime thread
+        if (detail::Context::current().runtime() != this->runtime_) {
+            forwarded_cancel_.request(this, this->runtime_);
+            return;
+        }
+        cancel_local_();
+    }
+
+    void cancel_local_() noexcept {
+        if (handle_->cancel_tick(this)) {
+            // Successfully canceled
+            this->schedule(-ECANCELED);
+        }
+    }
+
+    struct Cancellation {
+        TickFinishHandle *self;
+        void operator()() noexcept { self->cancel_(); }
+    };
+
+    using StopCallbackType =
+        stop_callback_t<stop_token_t<Receiver>, Cancellation>;
+
+private:
+    detail::IntervalHandle *handle_;
+    Receiver receiver_;
+    std::optional<StopCallbackType> stop_callback_;
+    detail::ForwardedCancellation<TickFinishHandle> forwarded_cancel_;
+};
+
+class Interval::TickSender {
+public:
+    using ReturnType = int32_t;
+
+    TickSender(detail::IntervalHandle *handle) : handle_(handle) {}
+
+    template <typename Receiver> auto connect(Receiver receiver) noexcept {
+        return OperationState<Receiver>(handle_, std::move(receiver));
+    }
+
+private:
+    template <typename Receiver>
+    class OperationState : public TickFinishHandle<Receiver> {
+    public:
+        using Base = TickFinishHandle<Receiver>;
+        using Base::Base;
+
+        void start(unsigned int /*flags*/) noexcept {
+            auto *runtime = detail::Context::current().runtime();
+            Base::start(runtime);
+        }
+    };
+
+    detail::IntervalHandle *handle_;
+};
+
+inline Interval::TickSender Interval::tick() noexcept { return {handle_}; }
+
+} // namespace condy
+
+#endif
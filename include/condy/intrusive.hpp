@@ -1,11 +1,13 @@
 /**
  * @file intrusive.hpp
- * @brief Intrusive single-linked and double-linked list implementations.
+ * @brief Intrusive single-linked and double-linked list implementations, and
+ * a lock-free multi-producer single-consumer list.
  */
 
 #pragma once
 
 #include "condy/utils.hpp"
+#include <atomic>
 #include <cassert>
 #include <utility>
 
@@ -122,6 +124,22 @@ public:
 
     bool empty() const noexcept { return head_ == nullptr; }
 
+    T *front() noexcept {
+        if (empty()) {
+            return nullptr;
+        }
+        return container_of(Member, head_);
+    }
+
+    T *next(T *item) noexcept {
+        assert(item != nullptr);
+        DoubleLinkEntry *entry = (item->*Member).next;
+        if (!entry) {
+            return nullptr;
+        }
+        return container_of(Member, entry);
+    }
+
     T *pop_front() noexcept {
         if (empty()) {
             return nullptr;
@@ -167,4 +185,65 @@ private:
     DoubleLinkEntry *tail_ = nullptr;
 };
 
-} // namespace condy
\ No newline at end of file
+/**
+ * @brief Lock-free multi-producer single-consumer intrusive list.
+ * @details Producers push items with a single CAS. The consumer takes all
+ * pushed items at once with pop_all(), which returns them in FIFO order.
+ */
+template <typename T, SingleLinkEntry T::*Member> class IntrusiveMpscList {
+public:
+    using List = IntrusiveSingleList<T, Member>;
+
+    IntrusiveMpscList() = default;
+
+    IntrusiveMpscList(const IntrusiveMpscList &) = delete;
+    IntrusiveMpscList &operator=(const IntrusiveMpscList &) = delete;
+    IntrusiveMpscList(IntrusiveMpscList &&) = delete;
+    IntrusiveMpscList &operator=(IntrusiveMpscList &&) = delete;
+
+public:
+    // Thread-safe.
+    void push(T *item) noexcept {
+        assert(item != nullptr);
+        SingleLinkEntry *entry = &(item->*Member);
+        assert(entry->next == nullptr);
+        SingleLinkEntry *head = head_.load(std::memory_order_relaxed);
+        do {
+            entry->next = head;
+        } while (!head_.compare_exchange_weak(head, entry,
+                                              std::memory_order_seq_cst,
+                                              std::memory_order_relaxed));
+    }
+
+    // Thread-safe.
+    bool empty() const noexcept { return head_.load() == nullptr; }
+
+    // Consumer only.
+    List pop_all() noexcept {
+        List list;
+        if (head_.load(std::memory_order_relaxed) == nullptr) {
+            return list;
+        }
+        SingleLinkEntry *entry = head_.exchange(nullptr);
+        // Items were pushed in LIFO order, reverse them first
+        SingleLinkEntry *reversed = nullptr;
+        while (entry != nullptr) {
+            SingleLinkEntry *next = entry->next;
+            entry->next = reversed;
+            reversed = entry;
+            entry = next;
+        }
+        while (reversed != nullptr) {
+            SingleLinkEntry *next = reversed->next;
+            reversed->next = nullptr;
+            list.push_back(container_of(Member, reversed));
+            reversed = next;
+        }
+        return list;
+    }
+
+private:
+    std::atomic<SingleLinkEntry *> head_ = nullptr;
+};
+
+} // namespace condy
@@ -7,6 +7,7 @@
 #pragma once
 
 #include "condy/intrusive.hpp"
+#include "condy/priority.hpp"
 
 namespace condy {
 
@@ -35,8 +36,19 @@ private:
 };
 
 class WorkInvoker : public Invoker {
+public:
+    // Priority in the run queue. Tasks take it when spawned, and awaiting
+    // operations take the priority of the task when they start, so that a task
+    // woken up through the run queue keeps its priority.
+    TaskPriority priority() const noexcept { return priority_; }
+
+    void set_priority(TaskPriority priority) noexcept { priority_ = priority; }
+
 public:
     SingleLinkEntry work_queue_entry_;
+
+private:
+    TaskPriority priority_ = TaskPriority::Normal;
 };
 
 } // namespace condy
\ No newline at end of file
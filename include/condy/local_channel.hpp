@@ -0,0 +1,117 @@
+/**
+ * @file local_channel.hpp
+ * @brief Single-runtime channel type for communication and synchronization.
+ * @details This file defines a channel type without any synchronization, which
+ * can be used for communication and synchronization between coroutines of the
+ * same Runtime.
+ */
+
+#pragma once
+
+#include "condy/channel.hpp"
+#include "condy/invoker.hpp"
+#include "condy/runtime.hpp"
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace condy {
+
+namespace detail {
+
+struct NullMutex {
+    void lock() noexcept {}
+    void unlock() noexcept {}
+    bool try_lock() noexcept { return true; }
+};
+
+/**
+ * @brief Drop-in replacement of std::atomic and std::atomic_ref, for data only
+ * accessed by one thread.
+ * @details Memory orders are ignored, and every operation is a plain load or
+ * store. T is a reference type to replace std::atomic_ref.
+ */
+template <typename T> class PlainAtomic {
+public:
+    using value_type = std::remove_reference_t<T>;
+
+    PlainAtomic(T value) noexcept : value_(value) {}
+
+    value_type
+    load(std::memory_order = std::memory_order_seq_cst) const noexcept {
+        return value_;
+    }
+
+    void store(value_type value,
+               std::memory_order = std::memory_order_seq_cst) noexcept {
+        value_ = value;
+    }
+
+    value_type
+    exchange(value_type value,
+             std::memory_order = std::memory_order_seq_cst) noexcept {
+        return std::exchange(value_, value);
+    }
+
+    value_type
+    fetch_add(value_type delta,
+              std::memory_order = std::memory_order_seq_cst) noexcept {
+        return std::exchange(value_, value_ + delta);
+    }
+
+    value_type
+    fetch_sub(value_type delta,
+              std::memory_order = std::memory_order_seq_cst) noexcept {
+        return std::exchange(value_, value_ - delta);
+    }
+
+    bool compare_exchange_weak(
+        value_type &expected, value_type desired,
+        std::memory_order = std::memory_order_seq_cst) noexcept {
+        if (value_ != expected) {
+            expected = value_;
+            return false;
+        }
+        value_ = desired;
+        return true;
+    }
+
+private:
+    T value_;
+};
+
+// Channel used by a single Runtime, from its own thread
+struct LocalChannelPolicy {
+    using Mutex = NullMutex;
+    template <typename U> using Atomic = PlainAtomic<U>;
+    template <typename U> using AtomicRef = PlainAtomic<U &>;
+
+    static void schedule(Runtime *runtime, WorkInvoker *work) noexcept {
+        runtime->schedule_local(work);
+    }
+};
+
+} // namespace detail
+
+/**
+ * @brief Single-runtime bounded channel for communication and synchronization.
+ * @tparam T Type of the items transmitted through the channel.
+ * @tparam N When the capacity is less than or equal to N, the channel uses
+ * stack storage for buffering; otherwise, it uses heap storage.
+ * @details This class shares its implementation and interface with Channel,
+ * but it can only be used by coroutines of a single Runtime, and from its
+ * thread. It takes no lock and uses no atomic operations, and awaiting
+ * operations are resumed through the local queue of the Runtime, so no system
+ * call is involved.
+ * @warning Using a LocalChannel from multiple threads is undefined behavior.
+ * Use Channel for inter-Runtime communication.
+ */
+template <typename T, size_t N = 2>
+class LocalChannel
+    : public detail::ChannelImpl<T, N, detail::LocalChannelPolicy> {
+public:
+    using detail::ChannelImpl<T, N, detail::LocalChannelPolicy>::ChannelImpl;
+};
+
+} // namespace condy
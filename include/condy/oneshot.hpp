@@ -0,0 +1,301 @@
+/**
+ * @file oneshot.hpp
+ * @brief Thread-safe oneshot channel type for request-response handoff.
+ * @details This file defines a thread-safe oneshot channel type, which
+ * transmits a single item, possibly across different Runtimes.
+ */
+
+#pragma once
+
+#include "condy/context.hpp"
+#include "condy/invoker.hpp"
+#include "condy/runtime.hpp"
+#include "condy/type_traits.hpp"
+#include "condy/utils.hpp"
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace condy {
+
+/**
+ * @brief Thread-safe oneshot channel for request-response handoff.
+ * @tparam T Type of the item transmitted through the channel.
+ * @details A oneshot channel transmits at most one item, from one sender to
+ * one receiver. It consists of a single atomic state word and an inline
+ * storage for the item, without any lock or waiter list, so it is cheap to
+ * create one for every request. The sender may run on any thread, and wakes
+ * up the awaiting receiver the same way as condy::Channel.
+ *
+ * The item may be sent by one thread, and received by one coroutine. close()
+ * may be called from either side, e.g. by the receiver once it is no longer
+ * interested in the item.
+ */
+template <typename T> class Oneshot {
+public:
+    Oneshot() = default;
+    ~Oneshot() {
+        close();
+        if (state_.load(std::memory_order_acquire) == ready_state) {
+            storage_.destroy();
+        }
+    }
+
+    Oneshot(const Oneshot &) = delete;
+    Oneshot &operator=(const Oneshot &) = delete;
+    Oneshot(Oneshot &&) = delete;
+    Oneshot &operator=(Oneshot &&) = delete;
+
+public:
+    /**
+     * @brief Send the item, waking up the awaiting receiver if any.
+     * @param item The item to be sent.
+     * @return int32_t 0 if the item was successfully sent; -EPIPE if the
+     * channel was already completed by send() or close().
+     */
+    template <typename U>
+        requires std::is_same_v<std::decay_t<U>, T>
+    int32_t send(U &&item) noexcept {
+        auto state = state_.load(std::memory_order_acquire);
+        if (is_completed_(state)) {
+            return -EPIPE;
+        }
+        storage_.construct(std::forward<U>(item));
+        while (true) {
+            if (state == empty_state) {
+                if (state_.compare_exchange_weak(state, ready_state,
+                                                 std::memory_order_acq_rel)) {
+                    return 0;
+                }
+                continue;
+            }
+            if (is_completed_(state)) {
+                // Closed concurrently
+                storage_.destroy();
+                return -EPIPE;
+            }
+            if (state_.compare_exchange_weak(state, taken_state,
+                                             std::memory_order_acq_rel)) {
+                auto *handle = reinterpret_cast<RecvFinishHandleBase *>(state);
+                handle->set_result({0, std::move(storage_.get())});
+                storage_.destroy();
+                handle->schedule();
+                return 0;
+            }
+        }
+    }
+
+    /**
+     * @brief Try to receive the item.
+     * @return std::pair<int32_t, T> 0 and the item if successful; -EPIPE if
+     * the channel is closed or the item was already received; -EAGAIN if the
+     * item has not been sent yet.
+     */
+    std::pair<int32_t, T> try_recv() noexcept {
+        auto state = state_.load(std::memory_order_acquire);
+        if (state == ready_state) {
+            return {0, take_()};
+        } else if (is_completed_(state)) {
+            return {-EPIPE, T()};
+        } else {
+            return {-EAGAIN, T()};
+        }
+    }
+
+    class [[nodiscard]] RecvSender;
+    /**
+     * @brief Receive the item, awaiting if necessary.
+     * @return std::pair<int32_t, T> 0 and the item if successful; -EPIPE if
+     * the channel is closed or the item was already received; -ECANCELED if
+     * the operation was cancelled while waiting.
+     */
+    RecvSender recv() noexcept { return {*this}; }
+
+    /**
+     * @brief Check if the item is ready to be received.
+     * @warning This function may not be accurate in multithreaded scenarios.
+     */
+    bool is_ready() const noexcept {
+        return state_.load(std::memory_order_acquire) == ready_state;
+    }
+
+    /**
+     * @brief Close the channel without sending an item.
+     * @details The awaiting receiver, if any, and future receives fail with
+     * -EPIPE. This function does nothing if the item was already sent.
+     * @note This function is idempotent.
+     */
+    void close() noexcept {
+        auto state = state_.load(std::memory_order_acquire);
+        while (!is_completed_(state)) {
+            if (state_.compare_exchange_weak(state, closed_state,
+                                             std::memory_order_acq_rel)) {
+                if (state != empty_state) {
+                    auto *handle =
+                        reinterpret_cast<RecvFinishHandleBase *>(state);
+                    handle->set_result({-EPIPE, T()});
+                    handle->schedule();
+                }
+                return;
+            }
+        }
+    }
+
+private:
+    class RecvFinishHandleBase;
+    template <typename Receiver> class RecvFinishHandle;
+
+    std::pair<int32_t, T>
+    request_recv_(RecvFinishHandleBase *finish_handle) noexcept {
+        auto result = try_recv();
+        if (result.first != -EAGAIN) {
+            return result;
+        }
+        auto *runtime = detail::Context::current().runtime();
+        runtime->pend_work();
+        auto state = empty_state;
+        if (state_.compare_exchange_strong(
+                state, reinterpret_cast<uintptr_t>(finish_handle),
+                std::memory_order_acq_rel)) {
+            return {-EAGAIN, T()};
+        }
+        // Completed concurrently
+        assert(is_completed_(state));
+        runtime->resume_work();
+        return try_recv();
+    }
+
+    bool cancel_recv_(RecvFinishHandleBase *finish_handle) noexcept {
+        auto state = reinterpret_cast<uintptr_t>(finish_handle);
+        return state_.compare_exchange_strong(state, empty_state,
+                                              std::memory_order_acq_rel);
+    }
+
+private:
+    // Other values of the state word are pointers to the awaiting receiver
+    static constexpr uintptr_t empty_state = 0;
+    static constexpr uintptr_t ready_state = 1;
+    static constexpr uintptr_t closed_state = 2;
+    static constexpr uintptr_t taken_state = 3;
+
+    static bool is_completed_(uintptr_t state) noexcept {
+        return state == ready_state || state == closed_state ||
+               state == taken_state;
+    }
+
+    T take_() noexcept {
+        T item = std::move(storage_.get());
+        storage_.destroy();
+        state_.store(taken_state, std::memory_order_relaxed);
+        return item;
+    }
+
+private:
+    std::atomic<uintptr_t> state_ = empty_state;
+    RawStorage<T> storage_;
+};
+
+template <typename T>
+class Oneshot<T>::RecvFinishHandleBase : public WorkInvoker {
+public:
+    void schedule() noexcept {
+        assert(runtime_ != nullptr);
+        runtime_->schedule(this);
+    }
+
+    void set_result(std::pair<int32_t, T> result) noexcept {
+        result_ = std::move(result);
+    }
+
+protected:
+    Runtime *runtime_ = nullptr;
+    // Internal error if not set
+    std::pair<int32_t, T> result_ = {-ENOTRECOVERABLE, T()};
+};
+
+template <typename T>
+template <typename Receiver>
+class Oneshot<T>::RecvFinishHandle
+    : public InvokerAdapter<RecvFinishHandle<Receiver>, RecvFinishHandleBase> {
+public:
+    RecvFinishHandle(Oneshot &oneshot, Receiver receiver)
+        : oneshot_(oneshot), receiver_(std::move(receiver)) {}
+
+    void start(Runtime *runtime) noexcept {
+        this->runtime_ = runtime;
+        this->set_priority(detail::Context::current().priority());
+        auto item = oneshot_.request_recv_(this);
+        if (item.first != -EAGAIN) {
+            std::move(receiver_)(std::move(item));
+            return;
+        }
+
+        auto stop_token = receiver_.get_stop_token();
+        if (stop_token.stop_possible()) {
+            stop_callback_.emplace(std::move(stop_token), Cancellation{this});
+        }
+    }
+
+    void invoke() noexcept {
+        stop_callback_.reset();
+        assert(this->runtime_ != nullptr);
+        this->runtime_->resume_work();
+        std::move(receiver_)(std::move(this->result_));
+    }
+
+private:
+    void cancel_() noexcept {
+        if (oneshot_.cancel_recv_(this)) {
+            // Successfully canceled
+            assert(this->result_.first == -ENOTRECOVERABLE);
+            this->result_.first = -ECANCELED;
+            assert(this->runtime_ != nullptr);
+            this->runtime_->schedule(this);
+        }
+    }
+
+    struct Cancellation {
+        RecvFinishHandle *self;
+        void operator()() noexcept { self->cancel_(); }
+    };
+
+    using StopCallbackType =
+        stop_callback_t<stop_token_t<Receiver>, Cancellation>;
+
+private:
+    Oneshot &oneshot_;
+    Receiver receiver_;
+    std::optional<StopCallbackType> stop_callback_;
+};
+
+template <typename T> class Oneshot<T>::RecvSender {
+public:
+    using ReturnType = std::pair<int32_t, T>;
+
+    RecvSender(Oneshot &oneshot) : oneshot_(oneshot) {}
+
+    template <typename Receiver> auto connect(Receiver receiver) noexcept {
+        return OperationState<Receiver>(oneshot_, std::move(receiver));
+    }
+
+private:
+    template <typename Receiver>
+    class OperationState
+        : public Oneshot<T>::template RecvFinishHandle<Receiver> {
+    public:
+        using Base = typename Oneshot<T>::template RecvFinishHandle<Receiver>;
+        using Base::Base;
+
+        void start(unsigned int /*flags*/) noexcept {
+            auto *runtime = detail::Context::current().runtime();
+            Base::start(runtime);
+        }
+    };
+
+    Oneshot &oneshot_;
+};
+
+} // namespace condy
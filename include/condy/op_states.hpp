@@ -8,9 +8,12 @@
 #include "condy/concepts.hpp"
 #include "condy/condy_uring.hpp"
 #include "condy/finish_handles.hpp"
+#include "condy/priority.hpp"
+#include "condy/timer.hpp"
 #include "condy/type_traits.hpp"
 #include "condy/utils.hpp"
 #include <array>
+#include <chrono>
 #include <cstddef>
 #include <optional>
 #include <stop_token>
@@ -39,6 +42,8 @@ public:
         context.runtime()->pend_work();
         io_uring_sqe *sqe = prep_func_(ring);
         assert(sqe && "prep_func must return a valid sqe");
+        prep_priority(sqe, context.priority());
+        finish_handle_.get().set_priority(context.priority());
         io_uring_sqe_set_flags(sqe, sqe->flags | flags);
         auto work = encode_work(&finish_handle_.get(), WorkType::Common);
         io_uring_sqe_set_data64(sqe, work);
@@ -69,6 +74,49 @@ private:
     OperationState op_state_;
 };
 
+template <typename Sender, typename Receiver> class LinkTimeoutOperationState {
+public:
+    LinkTimeoutOperationState(Sender sender,
+                              std::chrono::steady_clock::time_point deadline,
+                              Receiver receiver)
+        : op_state_(std::move(sender).connect(std::move(receiver))) {
+        // Absolute timeouts use CLOCK_MONOTONIC, the same as steady_clock
+        auto time = deadline.time_since_epoch();
+        auto secs = std::chrono::floor<std::chrono::seconds>(time);
+        ts_.tv_sec = secs.count();
+        ts_.tv_nsec =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(time - secs)
+                .count();
+    }
+
+    LinkTimeoutOperationState(LinkTimeoutOperationState &&) = delete;
+    LinkTimeoutOperationState &operator=(LinkTimeoutOperationState &&) = delete;
+    LinkTimeoutOperationState(const LinkTimeoutOperationState &) = delete;
+    LinkTimeoutOperationState &
+    operator=(const LinkTimeoutOperationState &) = delete;
+
+public:
+    void start(unsigned int flags) noexcept {
+        auto *ring = detail::Context::current().ring();
+        // The timeout must directly follow the operation
+        ring->reserve_space(2);
+        op_state_.start(flags | IOSQE_IO_LINK);
+        io_uring_sqe *sqe = ring->get_sqe();
+        io_uring_prep_link_timeout(sqe, &ts_, IORING_TIMEOUT_ABS);
+        // The timeout always completes with an error: -ETIME if it fires, or
+        // -ECANCELED if the operation completes first.
+        io_uring_sqe_set_data64(sqe, encode_work(nullptr, WorkType::Ignore));
+        // Keep the chain going if the operation is linked to the next one
+        io_uring_sqe_set_flags(sqe,
+                               flags & (IOSQE_IO_LINK | IOSQE_IO_HARDLINK));
+    }
+
+private:
+    using OperationState = operation_state_t<Sender, Receiver>;
+    OperationState op_state_;
+    __kernel_timespec ts_ = {};
+};
+
 template <typename TokenType> class WhenAnyCanceller {
 public:
     auto chain_token(TokenType token) noexcept {
@@ -221,6 +269,21 @@ template <typename Receiver> struct ReceiverAnyWrapper {
     auto get_stop_token() const noexcept { return receiver.get_stop_token(); }
 };
 
+template <typename Receiver> struct ReceiverFirstWrapper {
+    Receiver receiver;
+    ReceiverFirstWrapper(Receiver receiver) : receiver(std::move(receiver)) {}
+    template <typename R> void operator()(R &&result) noexcept {
+        auto &[order, results] = result;
+        std::move(receiver)(std::move(std::get<0>(results)));
+    }
+    auto get_stop_token() const noexcept { return receiver.get_stop_token(); }
+};
+
+template <typename Receiver, typename Sender>
+using TimerTimeoutOperationState =
+    ParallelAnyOperationState<ReceiverFirstWrapper<Receiver>, Sender,
+                              SleepSender>;
+
 template <typename Receiver, typename... Senders>
 using WhenAnyOperationState =
     ParallelAnyOperationState<ReceiverAnyWrapper<Receiver>, Senders...>;
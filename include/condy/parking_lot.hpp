@@ -0,0 +1,238 @@
+/**
+ * @file parking_lot.hpp
+ * @brief Global table of coroutines waiting on addresses.
+ * @details This file defines the parking lot used by condy::Futex and other
+ * synchronization primitives. Awaiting operations are parked in a fixed number
+ * of shards selected by address, so objects that can be waited on need no lock
+ * or wait list of their own.
+ */
+
+#pragma once
+
+#include "condy/context.hpp"
+#include "condy/intrusive.hpp"
+#include "condy/invoker.hpp"
+#include "condy/runtime.hpp"
+#include "condy/type_traits.hpp"
+#include "condy/utils.hpp"
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+
+namespace condy {
+
+namespace detail {
+
+/**
+ * @brief Awaiting operation parked on an address.
+ */
+class ParkingHandle : public WorkInvoker {
+public:
+    void schedule() noexcept {
+        assert(runtime_ != nullptr);
+        runtime_->schedule(this);
+    }
+
+    void set_result(int32_t result) noexcept { result_ = result; }
+
+public:
+    DoubleLinkEntry link_entry_;
+
+protected:
+    friend class ParkingLot;
+
+    const void *key_ = nullptr;
+    Runtime *runtime_ = nullptr;
+    int32_t result_ = -ENOTRECOVERABLE; // Internal error if not set
+};
+
+/**
+ * @brief Global table of awaiting operations, sharded by address.
+ * @details Each shard has its own lock, and a single intrusive wait queue
+ * shared by all addresses hashed to it, so parking never allocates. Handles
+ * remember their address, and waking up skips those of other addresses. Waking
+ * up operations is done after the shard lock is released.
+ */
+class ParkingLot {
+public:
+    static ParkingLot &instance() noexcept {
+        static ParkingLot instance;
+        return instance;
+    }
+
+    /**
+     * @brief Park the handle on the key if validate() returns true, which is
+     * called with the shard lock held.
+     * @return true if the handle was parked.
+     */
+    template <typename Validate>
+    bool park(const void *key, ParkingHandle *handle,
+              Validate &&validate) noexcept {
+        auto &shard = shard_(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (!validate()) {
+            return false;
+        }
+        handle->key_ = key;
+        shard.queue.push_back(handle);
+        return true;
+    }
+
+    /**
+     * @brief Remove the handle if it is still parked.
+     * @return true if the handle was removed.
+     */
+    bool cancel(const void *key, ParkingHandle *handle) noexcept {
+        auto &shard = shard_(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        assert(handle->key_ == key);
+        return shard.queue.remove(handle);
+    }
+
+    /**
+     * @brief Wake up at most max handles parked on the key, in FIFO order.
+     * @return size_t Number of handles woken up.
+     */
+    size_t unpark(const void *key, size_t max, int32_t result) noexcept {
+        HandleList woken;
+        size_t n = 0;
+        {
+            auto &shard = shard_(key);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto *handle = shard.queue.front();
+            while (n < max && handle != nullptr) {
+                auto *next = shard.queue.next(handle);
+                if (handle->key_ == key) {
+                    shard.queue.remove(handle);
+                    woken.push_back(handle);
+                    n++;
+                }
+                handle = next;
+            }
+        }
+        while (auto *handle = woken.pop_front()) {
+            handle->set_result(result);
+            handle->schedule();
+        }
+        return n;
+    }
+
+private:
+    ParkingLot() = default;
+
+    static constexpr size_t num_shards = 256;
+
+    using HandleList =
+        IntrusiveDoubleList<ParkingHandle, &ParkingHandle::link_entry_>;
+
+    struct alignas(cache_line_size) Shard {
+        std::mutex mutex;
+        // Handles of all addresses hashed to this shard, in FIFO order
+        HandleList queue;
+    };
+
+    Shard &shard_(const void *key) noexcept {
+        // Fibonacci hashing, the low bits of addresses are mostly zero
+        auto hash = reinterpret_cast<uintptr_t>(key) * 0x9e3779b97f4a7c15ull;
+        return shards_[(hash >> 32) % num_shards];
+    }
+
+    Shard shards_[num_shards];
+};
+
+/**
+ * @brief Operation that parks on an address until woken up.
+ * @details Condition provides key(), the address to park on; arrive(), called
+ * once when the operation starts; and should_park(), called with the shard
+ * lock held. The operation completes immediately with 0 if should_park()
+ * returns false.
+ */
+template <typename Condition, typename Receiver>
+class ParkFinishHandle
+    : public InvokerAdapter<ParkFinishHandle<Condition, Receiver>,
+                            ParkingHandle> {
+public:
+    ParkFinishHandle(Condition condition, Receiver receiver)
+        : condition_(std::move(condition)), receiver_(std::move(receiver)) {}
+
+    void start(Runtime *runtime) noexcept {
+        this->runtime_ = runtime;
+        this->set_priority(detail::Context::current().priority());
+        condition_.arrive();
+        if (!ParkingLot::instance().park(condition_.key(), this, [this]() {
+                return condition_.should_park();
+            })) {
+            std::move(receiver_)(0);
+            return;
+        }
+        runtime->pend_work();
+
+        auto stop_token = receiver_.get_stop_token();
+        if (stop_token.stop_possible()) {
+            stop_callback_.emplace(std::move(stop_token), Cancellation{this});
+        }
+    }
+
+    void invoke() noexcept {
+        stop_callback_.reset();
+        assert(this->runtime_ != nullptr);
+        this->runtime_->resume_work();
+        std::move(receiver_)(this->result_);
+    }
+
+private:
+    void cancel_() noexcept {
+        if (ParkingLot::instance().cancel(condition_.key(), this)) {
+            // Successfully canceled
+            this->result_ = -ECANCELED;
+            assert(this->runtime_ != nullptr);
+            this->runtime_->schedule(this);
+        }
+    }
+
+    struct Cancellation {
+        ParkFinishHandle *self;
+        void operator()() noexcept { self->cancel_(); }
+    };
+
+    using StopCallbackType =
+        stop_callback_t<stop_token_t<Receiver>, Cancellation>;
+
+private:
+    Condition condition_;
+    Receiver receiver_;
+    std::optional<StopCallbackType> stop_callback_;
+};
+
+template <typename Condition> class [[nodiscard]] ParkSender {
+public:
+    using ReturnType = int32_t;
+
+    ParkSender(Condition condition) : condition_(std::move(condition)) {}
+
+    template <typename Receiver> auto connect(Receiver receiver) noexcept {
+        return OperationState<Receiver>(std::move(condition_),
+                                        std::move(receiver));
+    }
+
+private:
+    template <typename Receiver>
+    class OperationState : public ParkFinishHandle<Condition, Receiver> {
+    public:
+        using Base = ParkFinishHandle<Condition, Receiver>;
+        using Base::Base;
+
+        void start(unsigned int /*flags*/) noexcept {
+            auto *runtime = detail::Context::current().runtime();
+            Base::start(runtime);
+        }
+    };
+
+    Condition condition_;
+};
+
+} // namespace detail
+
+} // namespace condy
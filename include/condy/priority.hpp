@@ -0,0 +1,70 @@
+/**
+ * @file priority.hpp
+ * @brief Priority classes of tasks.
+ */
+
+#pragma once
+
+#include "condy/condy_uring.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace condy {
+
+/**
+ * @brief Priority class of a task.
+ * @details Ready tasks of higher priority run first. Lower priorities are
+ * still served from time to time, so they are never starved. The priority
+ * also applies to the reads and writes submitted by the task, through the I/O
+ * priority of their SQEs.
+ *
+ * A task takes its priority when it is spawned: the given one, or else the
+ * priority of the spawning task at that time. Awaiting operations take the
+ * priority of the task when they start, so the task is woken up with it.
+ */
+enum class TaskPriority : uint8_t {
+    /// Latency-critical tasks, such as health checks and control messages
+    High,
+    /// Default priority
+    Normal,
+    /// Background tasks, such as bulk transfers
+    Low,
+};
+
+namespace detail {
+
+inline constexpr size_t num_task_priorities = 3;
+
+// I/O priority of the best-effort class, see ioprio_set(2). Unlike the
+// realtime class, it needs no privilege.
+inline constexpr uint16_t ioprio_best_effort(uint16_t level) noexcept {
+    constexpr uint16_t class_shift = 13;
+    constexpr uint16_t class_best_effort = 2;
+    return static_cast<uint16_t>((class_best_effort << class_shift) | level);
+}
+
+// Only reads and writes take an I/O priority, for most other opcodes the
+// ioprio field of the SQE holds flags instead.
+inline void prep_priority(io_uring_sqe *sqe, TaskPriority priority) noexcept {
+    if (priority == TaskPriority::Normal || sqe->ioprio != 0) {
+        return;
+    }
+    // Highest and lowest levels, normal tasks keep the default of the thread
+    uint16_t level = priority == TaskPriority::High ? 0 : 7;
+    switch (sqe->opcode) {
+    case IORING_OP_READ:
+    case IORING_OP_WRITE:
+    case IORING_OP_READV:
+    case IORING_OP_WRITEV:
+    case IORING_OP_READ_FIXED:
+    case IORING_OP_WRITE_FIXED:
+        sqe->ioprio = ioprio_best_effort(level);
+        break;
+    default:
+        break;
+    }
+}
+
+} // namespace detail
+
+} // namespace condy
@@ -8,8 +8,11 @@
 #pragma once
 
 #include "condy/condy_uring.hpp"
+#include "condy/runtime_stats.hpp"
+#include <algorithm>
 #include <cassert>
 #include <cerrno>
+#include <chrono>
 #include <cstddef>
 #include <cstring>
 
@@ -314,6 +317,10 @@ private:
 
 class Ring {
 public:
+    struct NoPrefetch {
+        void operator()(io_uring_cqe *) const noexcept {}
+    };
+
     Ring() = default;
     ~Ring() { destroy(); }
 
@@ -352,16 +359,17 @@ public:
         }
     }
 
-    void submit() noexcept { io_uring_submit(&ring_); }
+    void submit() noexcept { record_submit_(io_uring_submit(&ring_)); }
 
-    template <typename Func>
-    ssize_t reap_completions_wait(Func &&process_func) noexcept {
-        unsigned head;
-        io_uring_cqe *cqe;
-        ssize_t reaped = 0;
+    template <typename Func, typename PrefetchFunc = NoPrefetch>
+    ssize_t reap_completions_wait(Func &&process_func,
+                                  PrefetchFunc &&prefetch_func = {}) noexcept {
+        stats_.parks++;
+        auto start = std::chrono::steady_clock::now();
         do {
-            int r = io_uring_submit_and_wait(&ring_, 1);
+            int r = submit_and_wait_();
             if (r >= 0) [[likely]] {
+                record_submit_(r);
                 break;
             } else if (r == -EINTR) {
                 continue;
@@ -369,21 +377,14 @@ public:
                 return r;
             }
         } while (true);
+        stats_.park_time += std::chrono::steady_clock::now() - start;
 
-        io_uring_for_each_cqe(&ring_, head, cqe) {
-            process_func(cqe);
-#if !IO_URING_CHECK_VERSION(2, 13) // >= 2.13
-            reaped += io_uring_cqe_nr(cqe);
-#else
-            reaped++;
-#endif
-        }
-        io_uring_cq_advance(&ring_, reaped);
-        return reaped;
+        return for_each_cqe_(process_func, prefetch_func);
     }
 
-    template <typename Func>
-    ssize_t reap_completions(Func &&process_func) noexcept {
+    template <typename Func, typename PrefetchFunc = NoPrefetch>
+    ssize_t reap_completions(Func &&process_func,
+                             PrefetchFunc &&prefetch_func = {}) noexcept {
         io_uring_cqe *cqe;
         int r = io_uring_peek_cqe(&ring_, &cqe);
         if (r == -EAGAIN) {
@@ -392,18 +393,18 @@ public:
             return r;
         }
 
-        unsigned head;
-        ssize_t reaped = 0;
-        io_uring_for_each_cqe(&ring_, head, cqe) {
-            process_func(cqe);
-#if !IO_URING_CHECK_VERSION(2, 13) // >= 2.13
-            reaped += io_uring_cqe_nr(cqe);
-#else
-            reaped++;
-#endif
-        }
-        io_uring_cq_advance(&ring_, reaped);
-        return reaped;
+        return for_each_cqe_(process_func, prefetch_func);
+    }
+
+    /**
+     * @brief Set the wait batch used by reap_completions_wait()
+     * @details When waiting for completions, wait until wait_nr CQEs are
+     * ready, or until min_wait_usec microseconds have passed and at least one
+     * CQE is ready.
+     */
+    void set_wait_batch(unsigned wait_nr, unsigned min_wait_usec) noexcept {
+        wait_nr_ = wait_nr;
+        min_wait_usec_ = min_wait_usec;
     }
 
     void reserve_space(size_t n) noexcept {
@@ -425,6 +426,8 @@ public:
 
     RingSettings &settings() noexcept { return settings_; }
 
+    RuntimeStats &stats() noexcept { return stats_; }
+
     io_uring_sqe *get_sqe() noexcept { return get_sqe_<io_uring_get_sqe>(); }
 
 #if !IO_URING_CHECK_VERSION(2, 13) // >= 2.13
@@ -438,6 +441,95 @@ public:
 #endif
 
 private:
+    // Process ready CQEs in windows. All CQEs of a window are passed to
+    // prefetch_func before any of them is processed, so that memory referenced
+    // by them can be loaded in parallel. The CQ head is advanced once at the
+    // end.
+    template <typename Func, typename PrefetchFunc>
+    ssize_t for_each_cqe_(Func &process_func,
+                          PrefetchFunc &prefetch_func) noexcept {
+        io_uring_cqe *window[cqe_window_size];
+        size_t window_size = 0;
+        auto flush_window = [&]() {
+            for (size_t i = 0; i < window_size; i++) {
+                prefetch_func(window[i]);
+            }
+            for (size_t i = 0; i < window_size; i++) {
+                process_func(window[i]);
+            }
+            window_size = 0;
+        };
+
+        unsigned head;
+        io_uring_cqe *cqe;
+        ssize_t reaped = 0;
+        io_uring_for_each_cqe(&ring_, head, cqe) {
+            window[window_size++] = cqe;
+            if (window_size == cqe_window_size) {
+                flush_window();
+            }
+#if !IO_URING_CHECK_VERSION(2, 13) // >= 2.13
+            reaped += io_uring_cqe_nr(cqe);
+#else
+            reaped++;
+#endif
+        }
+        flush_window();
+        io_uring_cq_advance(&ring_, reaped);
+        return reaped;
+    }
+
+    int submit_and_wait_() noexcept {
+        if (wait_nr_ <= 1) [[likely]] {
+            return io_uring_submit_and_wait(&ring_, 1);
+        }
+        unsigned ready = io_uring_sq_ready(&ring_);
+        int r = submit_and_wait_batch_();
+        if (r != -ETIME) {
+            return r;
+        }
+        // The SQEs are submitted even if the wait times out, count them from
+        // the SQ head consumed by the kernel
+        record_submit_(static_cast<int>(ready - io_uring_sq_ready(&ring_)));
+        if (io_uring_cq_ready(&ring_) != 0) {
+            return 0;
+        }
+        // Nothing completed in time, wait for one
+        return io_uring_submit_and_wait(&ring_, 1);
+    }
+
+    // Wait for wait_nr_ completions, or until min_wait_usec_ has passed
+    int submit_and_wait_batch_() noexcept {
+        io_uring_cqe *cqe;
+#if !IO_URING_CHECK_VERSION(2, 8) // >= 2.8
+        if (settings_.features_ & IORING_FEAT_MIN_TIMEOUT) {
+            return io_uring_submit_and_wait_min_timeout(
+                &ring_, &cqe, wait_nr_, nullptr, min_wait_usec_, nullptr);
+        }
+#endif
+        // Without IORING_FEAT_EXT_ARG, liburing implements the timeout with
+        // an internal timeout SQE, which we can not distinguish when reaping.
+        if (settings_.features_ & IORING_FEAT_EXT_ARG) {
+            __kernel_timespec ts = {
+                .tv_sec = min_wait_usec_ / 1'000'000,
+                .tv_nsec = (min_wait_usec_ % 1'000'000) * 1000,
+            };
+            return io_uring_submit_and_wait_timeout(&ring_, &cqe, wait_nr_,
+                                                    &ts, nullptr);
+        }
+        return io_uring_submit_and_wait(&ring_, 1);
+    }
+
+    void record_submit_(int submitted) noexcept {
+        if (submitted <= 0) {
+            return;
+        }
+        size_t n = static_cast<size_t>(submitted);
+        stats_.submits++;
+        stats_.submitted_sqes += n;
+        stats_.max_submit_batch = std::max(stats_.max_submit_batch, n);
+    }
+
     template <io_uring_sqe *(*get_sqe)(struct io_uring *)>
     io_uring_sqe *get_sqe_() noexcept {
         [[maybe_unused]] int r;
@@ -449,6 +541,7 @@ private:
             }
             r = io_uring_submit(&ring_);
             assert(r >= 0);
+            record_submit_(r);
             if (sqpoll_mode_) {
                 r = io_uring_sqring_wait(&ring_);
                 assert(r >= 0);
@@ -458,13 +551,18 @@ private:
     }
 
 private:
+    static constexpr size_t cqe_window_size = 16;
+
     bool initialized_ = false;
     io_uring ring_;
     bool sqpoll_mode_ = false;
+    unsigned wait_nr_ = 1;
+    unsigned min_wait_usec_ = 0;
 
     FdTable fd_table_{ring_};
     BufferTable buffer_table_{ring_};
     RingSettings settings_{ring_};
+    RuntimeStats stats_;
 };
 
 } // namespace condy
\ No newline at end of file
@@ -0,0 +1,89 @@
+/**
+ * @file run_queue.hpp
+ * @brief Multi-level queue of ready works.
+ * @details This file defines the local run queue of condy::Runtime, which
+ * keeps one FIFO list per task priority.
+ */
+
+#pragma once
+
+#include "condy/intrusive.hpp"
+#include "condy/invoker.hpp"
+#include "condy/priority.hpp"
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace condy {
+
+namespace detail {
+
+/**
+ * @brief Queue of ready works, ordered by priority.
+ * @details Works of higher priority are popped first, and works of the same
+ * priority in FIFO order. To avoid starvation, a non-empty level that has been
+ * passed over aging_threshold times in a row is served next, ahead of higher
+ * levels.
+ */
+class RunQueue {
+public:
+    static constexpr uint32_t aging_threshold = 32;
+
+    using WorkList =
+        IntrusiveSingleList<WorkInvoker, &WorkInvoker::work_queue_entry_>;
+
+    RunQueue() = default;
+
+    RunQueue(const RunQueue &) = delete;
+    RunQueue &operator=(const RunQueue &) = delete;
+    RunQueue(RunQueue &&) = delete;
+    RunQueue &operator=(RunQueue &&) = delete;
+
+public:
+    bool empty() const noexcept { return non_empty_ == 0; }
+
+    void push_back(WorkInvoker *work) noexcept {
+        auto level = static_cast<size_t>(work->priority());
+        levels_[level].push_back(work);
+        if ((non_empty_ & (1u << level)) == 0) {
+            // Aging starts over once a level is refilled
+            passed_over_[level] = 0;
+            non_empty_ |= 1u << level;
+        }
+    }
+
+    void push_back(WorkList works) noexcept {
+        while (auto *work = works.pop_front()) {
+            push_back(work);
+        }
+    }
+
+    WorkInvoker *pop_front() noexcept {
+        if (non_empty_ == 0) {
+            return nullptr;
+        }
+        auto level = static_cast<size_t>(std::countr_zero(non_empty_));
+        // The lowest level waiting for too long goes first
+        for (size_t lower = level + 1; lower < num_task_priorities; lower++) {
+            if ((non_empty_ & (1u << lower)) != 0 &&
+                ++passed_over_[lower] >= aging_threshold) {
+                level = lower;
+            }
+        }
+        passed_over_[level] = 0;
+        auto *work = levels_[level].pop_front();
+        if (levels_[level].empty()) {
+            non_empty_ &= ~(1u << level);
+        }
+        return work;
+    }
+
+private:
+    WorkList levels_[num_task_priorities];
+    uint32_t passed_over_[num_task_priorities] = {};
+    uint32_t non_empty_ = 0;
+};
+
+} // namespace detail
+
+} // namespace condy
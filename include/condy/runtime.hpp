@@ -5,24 +5,35 @@
 
 #pragma once
 
+#include "condy/block_cache.hpp"
 #include "condy/condy_uring.hpp"
 #include "condy/context.hpp"
 #include "condy/intrusive.hpp"
 #include "condy/invoker.hpp"
+#include "condy/priority.hpp"
 #include "condy/ring.hpp"
+#include "condy/run_queue.hpp"
 #include "condy/runtime_options.hpp"
+#include "condy/runtime_stats.hpp"
 #include "condy/singleton.hpp"
+#include "condy/timer_wheel.hpp"
 #include "condy/utils.hpp"
 #include "condy/work_type.hpp"
+#include <algorithm>
 #include <atomic>
 #include <cerrno>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <mutex>
+#include <optional>
+#include <span>
 
 namespace condy {
 
+class RuntimePool;
+
 namespace detail {
 
 class ThreadLocalRing : public ThreadLocalSingleton<ThreadLocalRing> {
@@ -95,11 +106,17 @@ public:
         return handle_func_(this, cqe);
     }
 
+    // Priority of the task that started the operation
+    TaskPriority priority() const noexcept { return priority_; }
+
+    void set_priority(TaskPriority priority) noexcept { priority_ = priority; }
+
 protected:
     OpFinishHandleBase() = default;
 
 protected:
     HandleFunc handle_func_ = nullptr;
+    TaskPriority priority_ = TaskPriority::Normal;
 };
 
 /**
@@ -204,6 +221,23 @@ public:
         }
 
         event_interval_ = options.event_interval_;
+        adaptive_event_interval_ = options.enable_adaptive_event_interval_;
+        min_event_interval_ = options.min_event_interval_;
+        max_event_interval_ = options.max_event_interval_;
+        if (adaptive_event_interval_) {
+            event_interval_ = std::clamp(event_interval_, min_event_interval_,
+                                         max_event_interval_);
+        }
+        ticks_until_flush_ = event_interval_;
+        submit_batch_ = options.submit_batch_;
+        submit_latency_ = options.submit_latency_;
+        enable_submit_on_tick_ = options.enable_submit_on_tick_;
+        task_budget_ = options.task_budget_;
+        busy_poll_ = options.busy_poll_;
+        ring_.set_wait_batch(
+            static_cast<unsigned>(options.wait_batch_nr_),
+            static_cast<unsigned>(options.wait_batch_timeout_.count()));
+        disable_frame_cache_ = options.disable_frame_cache_;
         disable_register_ring_fd_ = options.disable_register_ring_fd_;
     }
 
@@ -223,7 +257,7 @@ public:
      * @note This function is thread-safe and can be called from any thread.
      */
     void allow_exit() noexcept {
-        pending_works_--;
+        remote_pending_works_--;
         wakeup_();
     }
 
@@ -234,27 +268,16 @@ public:
             return;
         }
 
-        auto state = state_.load();
-        if (state == State::Enabled) {
-            // Fast path: if the ring is enabled, we can directly schedule the
-            // work
-            tsan_release(work);
-            schedule_msg_ring_(curr_runtime,
-                               encode_work(work, WorkType::Schedule));
-        } else {
-            // Slow path: if the ring is not enabled, we need to acquire the
-            // mutex to ensure the work is scheduled before the ring is enabled
-            std::unique_lock<std::mutex> lock(mutex_);
-            state = state_.load();
-            if (state == State::Enabled) {
-                lock.unlock();
-                tsan_release(work);
-                schedule_msg_ring_(curr_runtime,
-                                   encode_work(work, WorkType::Schedule));
-            } else {
-                global_queue_.push_back(work);
-            }
-        }
+        // Remote works are collected by the runtime thread in batch, only
+        // ring the doorbell if it may be blocked in the kernel.
+        remote_queue_.push(work);
+        wakeup_();
+    }
+
+    // Must be called in the runtime thread.
+    void schedule_local(WorkInvoker *work) noexcept {
+        assert(detail::Context::current().runtime() == this);
+        local_queue_.push_back(work);
     }
 
     // Internal use only. Schedule a cancel request for the given data.
@@ -285,9 +308,51 @@ public:
         request.wait();
     }
 
-    void pend_work() noexcept { pending_works_++; }
+    // Must be called in the runtime thread. Return false if the deadline has
+    // already passed, in which case the timer is not added.
+    bool add_timer(detail::TimerHandle *handle,
+                   std::chrono::steady_clock::time_point deadline) noexcept {
+        assert(detail::Context::current().runtime() == this);
+        // Round up, timers never expire early
+        auto ticks = std::chrono::ceil<std::chrono::milliseconds>(
+                         deadline - timer_epoch_)
+                         .count();
+        expire_timers_(timer_now_());
+        if (ticks <= 0 ||
+            !timer_wheel_.insert(handle, static_cast<uint64_t>(ticks))) {
+            return false;
+        }
+        arm_timer_();
+        return true;
+    }
+
+    // Must be called in the runtime thread. Return true if the timer is
+    // removed before it expires. This never touches the ring.
+    bool cancel_timer(detail::TimerHandle *handle) noexcept {
+        assert(detail::Context::current().runtime() == this);
+        return timer_wheel_.remove(handle);
+    }
+
+    // Must be called in the runtime thread. Charge a synchronous resumption to
+    // the running task, return false once its budget is used up, in which case
+    // the task should yield to the local queue.
+    bool consume_budget() noexcept {
+        if (budget_left_ == 0) {
+            if (task_budget_ == 0) {
+                return true;
+            }
+            ring_.stats().budget_yields++;
+            return false;
+        }
+        budget_left_--;
+        return true;
+    }
 
-    void resume_work() noexcept { pending_works_--; }
+    // Must be called in the runtime thread.
+    void pend_work() noexcept { local_pending_works_++; }
+
+    // Must be called in the runtime thread.
+    void resume_work() noexcept { local_pending_works_--; }
 
     /**
      * @brief Run the runtime event loop in the current thread.
@@ -311,41 +376,85 @@ public:
         r = io_uring_enable_rings(ring_.ring());
         assert(r == 0);
 
-        {
-            std::lock_guard<std::mutex> lock(mutex_);
-            flush_global_queue_();
-            // Now that the ring is enabled and all pending works are scheduled,
-            // we can set the state to Enabled.
-            state_.store(State::Enabled);
-        }
+        state_.store(State::Enabled);
 
         if (!disable_register_ring_fd_) {
             r = io_uring_register_ring_fd(ring_.ring());
             assert(r == 1); // 1 indicates success for this call
         }
 
-        detail::Context::current().init(&ring_, this);
+        detail::Context::current().init(
+            &ring_, this, disable_frame_cache_ ? nullptr : &block_cache_);
         auto d2 = defer([]() { detail::Context::current().reset(); });
 
+        bool check_submit =
+            submit_batch_ != 0 || submit_latency_.count() != 0;
+
         while (true) {
-            tick_count_++;
+            if (check_submit) {
+                maybe_submit_();
+            }
 
-            if (tick_count_ % event_interval_ == 0) {
-                flush_ring_();
+            if (--ticks_until_flush_ == 0) {
+                if (enable_submit_on_tick_) {
+                    submit_ring_();
+                }
+                size_t reaped = flush_ring_();
+                auto &stats = ring_.stats();
+                stats.event_checks++;
+                stats.empty_event_checks += (reaped == 0);
+                if (adaptive_event_interval_) {
+                    adapt_event_interval_(reaped);
+                }
+                ticks_until_flush_ = event_interval_;
+                flush_remote_queue_();
+                flush_shared_queue_();
             }
 
             if (auto *work = local_queue_.pop_front()) {
-                (*work)();
+                run_work_(work);
                 continue;
             }
 
-            if (pending_works_ == 0) {
+            if (flush_remote_queue_()) {
+                continue;
+            }
+
+            if (auto *work = find_shared_work_()) {
+                run_work_(work);
+                continue;
+            }
+
+            if (should_exit_()) {
+                wakeup_peers_on_exit_();
                 break;
             }
+
+            if (busy_poll_.count() != 0 && busy_poll_events_()) {
+                continue;
+            }
+
+            // Publish sleeping before the final check, so that a remote
+            // producer either sees us sleeping or we see its work.
+            sleeping_.store(true);
+            if (!remote_queue_.empty() || has_shared_work_() ||
+                should_exit_()) {
+                sleeping_.store(false, std::memory_order_relaxed);
+                continue;
+            }
             flush_ring_wait_();
+            sleeping_.store(false, std::memory_order_relaxed);
         }
     }
 
+    /**
+     * @brief Get the statistics of the runtime.
+     * @return const RuntimeStats& Reference to the statistics of the runtime.
+     * @note Counters are not synchronized. Read them in the runtime thread or
+     * after the runtime exits.
+     */
+    const RuntimeStats &stats() noexcept { return ring_.stats(); }
+
     /**
      * @brief Get the file descriptor table of the runtime.
      * @return FdTable& Reference to the fd table of the runtime.
@@ -365,6 +474,151 @@ public:
     auto &settings() noexcept { return ring_.settings(); }
 
 private:
+    void run_work_(WorkInvoker *work) noexcept {
+        budget_left_ = task_budget_;
+        detail::Context::current().set_priority(work->priority());
+        (*work)();
+    }
+
+    bool has_pending_works_() const noexcept {
+        return local_pending_works_ != 0 || remote_pending_works_.load() != 0;
+    }
+
+    // Runtimes of a pool only exit together, once none of them has pending
+    // works and all shared queues are drained, so that idle runtimes keep
+    // stealing from busy ones.
+    bool should_exit_() noexcept {
+        if (has_pending_works_()) {
+            set_pool_idle_(false);
+            return false;
+        }
+        if (pool_busy_ == nullptr) {
+            return true;
+        }
+        set_pool_idle_(true);
+        return pool_busy_->load() == 0 && !has_shared_work_();
+    }
+
+    // Maintain the number of busy runtimes in the pool
+    void set_pool_idle_(bool idle) noexcept {
+        if (pool_busy_ == nullptr || pool_idle_ == idle) {
+            return;
+        }
+        pool_idle_ = idle;
+        if (idle) {
+            pool_busy_->fetch_sub(1);
+        } else {
+            pool_busy_->fetch_add(1);
+        }
+    }
+
+    // Wake up sleeping peers so that they see the pool is drained. The
+    // doorbells are sent synchronously, since this runtime is exiting.
+    void wakeup_peers_on_exit_() noexcept {
+        for (auto *peer : peers_) {
+            if (peer != this && peer->sleeping_.load() &&
+                peer->sleeping_.exchange(false)) {
+                peer->schedule_msg_ring_(
+                    nullptr, encode_work(nullptr, WorkType::Ignore));
+            }
+        }
+    }
+
+    // Push work into the shared queue, which can be stolen by peers in the
+    // same RuntimePool. Thread-safe.
+    void post_(WorkInvoker *work) noexcept {
+        {
+            std::lock_guard<std::mutex> lock(shared_mutex_);
+            shared_queue_.push_back(work);
+            shared_size_.fetch_add(1);
+        }
+        auto *curr_runtime = detail::Context::current().runtime();
+        if (curr_runtime != this) {
+            wakeup_();
+        } else {
+            // We are busy, let a sleeping peer steal the work.
+            wakeup_sleeping_peer_();
+        }
+    }
+
+    // Pop work from the shared queue. Thread-safe.
+    WorkInvoker *steal_() noexcept {
+        if (shared_size_.load() == 0) {
+            return nullptr;
+        }
+        std::lock_guard<std::mutex> lock(shared_mutex_);
+        auto *work = shared_queue_.pop_front();
+        if (work != nullptr) {
+            shared_size_.fetch_sub(1, std::memory_order_relaxed);
+        }
+        return work;
+    }
+
+    WorkInvoker *find_shared_work_() noexcept {
+        if (pool_idle_) {
+            if (!has_shared_work_()) {
+                return nullptr;
+            }
+            // Count as busy before taking any work, see should_exit_()
+            set_pool_idle_(false);
+        }
+        if (auto *work = steal_()) {
+            return work;
+        }
+        for (size_t i = 1; i < peers_.size(); i++) {
+            auto *peer = peers_[(peer_index_ + i) % peers_.size()];
+            if (auto *work = peer->steal_()) {
+                return work;
+            }
+        }
+        return nullptr;
+    }
+
+    bool has_shared_work_() const noexcept {
+        if (shared_size_.load() != 0) {
+            return true;
+        }
+        for (auto *peer : peers_) {
+            if (peer->shared_size_.load() != 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Make sure the shared queue makes progress even if this runtime never
+    // becomes idle. Take half of it, and leave the rest to idle peers.
+    void flush_shared_queue_() noexcept {
+        if (shared_size_.load() == 0) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(shared_mutex_);
+        size_t n = (shared_size_.load(std::memory_order_relaxed) + 1) / 2;
+        for (size_t i = 0; i < n; i++) {
+            local_queue_.push_back(shared_queue_.pop_front());
+        }
+        shared_size_.fetch_sub(n, std::memory_order_relaxed);
+    }
+
+    void wakeup_sleeping_peer_() noexcept {
+        for (size_t i = 1; i < peers_.size(); i++) {
+            auto *peer = peers_[(peer_index_ + i) % peers_.size()];
+            if (peer->wakeup_()) {
+                return;
+            }
+        }
+    }
+
+    // Move remote works to the local queue. Return true if any work is moved.
+    bool flush_remote_queue_() noexcept {
+        if (remote_queue_.empty()) {
+            return false;
+        }
+        set_pool_idle_(false);
+        local_queue_.push_back(remote_queue_.pop_all());
+        return true;
+    }
+
     void schedule_msg_ring_(Runtime *curr_runtime, uintptr_t data) noexcept {
         int ring_fd = this->ring_.ring()->ring_fd;
         if (curr_runtime != nullptr) {
@@ -381,24 +635,23 @@ private:
         }
     }
 
-    // Wakeup the runtime if it's blocked in Ring::reap_completions_wait()
-    void wakeup_() noexcept {
+    // Wakeup the runtime if it's blocked in Ring::reap_completions_wait().
+    // Return true if a doorbell message is sent.
+    bool wakeup_() noexcept {
         auto *curr_runtime = detail::Context::current().runtime();
         if (curr_runtime == this) {
-            return;
+            // Running on this runtime, so it is not blocked
+            sleeping_.store(false, std::memory_order_relaxed);
+            return false;
         }
-
-        auto state = state_.load();
-        if (state != State::Enabled) {
-            return;
+        // Only one waker can claim the sleeping flag, so at most one doorbell
+        // is sent per sleep.
+        if (!sleeping_.load() || !sleeping_.exchange(false)) {
+            return false;
         }
-
         schedule_msg_ring_(curr_runtime,
                            encode_work(nullptr, WorkType::Ignore));
-    }
-
-    void flush_global_queue_() noexcept {
-        local_queue_.push_back(std::move(global_queue_));
+        return true;
     }
 
     static void prep_msg_ring_(int ring_fd, io_uring_sqe *sqe,
@@ -413,24 +666,164 @@ private:
         io_uring_sqe_set_flags(sqe, IOSQE_CQE_SKIP_SUCCESS);
     }
 
-    void flush_ring_() noexcept {
+    void submit_ring_() noexcept {
+        if (io_uring_sq_ready(ring_.ring()) != 0) {
+            ring_.submit();
+        }
+    }
+
+    bool has_ready_events_() noexcept {
+        io_uring *ring = ring_.ring();
+        if (io_uring_cq_ready(ring) != 0) {
+            return true;
+        }
+        // Completions are not visible until task work runs or the overflow
+        // list is flushed.
+        unsigned flags = __atomic_load_n(ring->sq.kflags, __ATOMIC_RELAXED);
+        return (flags & (IORING_SQ_CQ_OVERFLOW | IORING_SQ_TASKRUN)) != 0;
+    }
+
+    // Spin for a while before parking. Return true if any event arrives.
+    bool busy_poll_events_() noexcept {
+        submit_ring_();
+        auto &stats = ring_.stats();
+        stats.busy_polls++;
+        auto start = std::chrono::steady_clock::now();
+        auto deadline = start + busy_poll_;
+        auto now = start;
+        bool hit = false;
+        do {
+            if (has_ready_events_()) {
+                flush_ring_();
+                hit = true;
+                break;
+            }
+            if (!remote_queue_.empty() || has_shared_work_() ||
+                should_exit_()) {
+                hit = true;
+                break;
+            }
+            cpu_relax();
+            now = std::chrono::steady_clock::now();
+        } while (now < deadline);
+        if (hit) {
+            now = std::chrono::steady_clock::now();
+            stats.busy_poll_hits++;
+        }
+        stats.busy_poll_time += now - start;
+        return hit;
+    }
+
+    // Submit queued SQEs if the submission policy says so
+    void maybe_submit_() noexcept {
+        unsigned ready = io_uring_sq_ready(ring_.ring());
+        if (ready == 0) {
+            sq_pending_since_.reset();
+            return;
+        }
+        if (submit_batch_ != 0 && ready >= submit_batch_) {
+            ring_.submit();
+            sq_pending_since_.reset();
+            return;
+        }
+        if (submit_latency_.count() != 0) {
+            auto now = std::chrono::steady_clock::now();
+            if (!sq_pending_since_) {
+                sq_pending_since_ = now;
+            } else if (now - *sq_pending_since_ >= submit_latency_) {
+                ring_.submit();
+                sq_pending_since_.reset();
+            }
+        }
+    }
+
+    size_t flush_ring_() noexcept {
         auto r = ring_.reap_completions(
-            [this](io_uring_cqe *cqe) { process_cqe_(cqe); });
+            [this](io_uring_cqe *cqe) { process_cqe_(cqe); },
+            [](io_uring_cqe *cqe) { prefetch_cqe_(cqe); });
         if (r < 0) {
             panic_on(std::format("io_uring_peek_cqe: {}",
                                  std::strerror(static_cast<int>(-r))));
         }
+        return static_cast<size_t>(r);
+    }
+
+    void adapt_event_interval_(size_t reaped) noexcept {
+        size_t cq_entries = ring_.ring()->cq.ring_entries;
+        if (reaped >= cq_entries / 4) {
+            // Completions pile up, check more often to avoid CQ overflow
+            event_interval_ =
+                std::max(event_interval_ / 2, min_event_interval_);
+        } else if (reaped == 0 && !local_queue_.empty()) {
+            // Busy running tasks while nothing completes, check less often
+            event_interval_ =
+                std::min(event_interval_ * 2, max_event_interval_);
+        }
+    }
+
+    // Milliseconds since the timer epoch, rounded down
+    uint64_t timer_now_() const noexcept {
+        auto now = std::chrono::steady_clock::now();
+        return std::chrono::floor<std::chrono::milliseconds>(now - timer_epoch_)
+            .count();
+    }
+
+    void expire_timers_(uint64_t now) noexcept {
+        timer_wheel_.advance(now, [this](detail::TimerHandle *handle) {
+            local_queue_.push_back(handle);
+        });
+    }
+
+    // Make sure the kernel timeout expires no later than the earliest timer.
+    // The timeout is left armed when timers are removed, it just fires for
+    // nothing then.
+    void arm_timer_() noexcept {
+        auto expiration = timer_wheel_.next_expiration();
+        if (!expiration || (timer_armed_ && *timer_armed_ <= *expiration)) {
+            return;
+        }
+        // Absolute timeouts use CLOCK_MONOTONIC, the same as steady_clock
+        auto deadline = timer_epoch_.time_since_epoch() +
+                        std::chrono::milliseconds(*expiration);
+        auto secs = std::chrono::floor<std::chrono::seconds>(deadline);
+        timer_ts_.tv_sec = secs.count();
+        timer_ts_.tv_nsec = (deadline - secs).count();
+
+        io_uring_sqe *sqe = ring_.get_sqe();
+        auto data = encode_work(nullptr, WorkType::Timer);
+        if (!timer_armed_) {
+            io_uring_prep_timeout(sqe, &timer_ts_, 0, IORING_TIMEOUT_ABS);
+            io_uring_sqe_set_data64(sqe, data);
+        } else {
+            // Fails with ENOENT if the timeout has just fired, then it is
+            // armed again when its CQE is processed.
+            io_uring_prep_timeout_update(sqe, &timer_ts_, data,
+                                         IORING_TIMEOUT_ABS);
+            io_uring_sqe_set_data64(sqe,
+                                    encode_work(nullptr, WorkType::Ignore));
+            io_uring_sqe_set_flags(sqe, IOSQE_CQE_SKIP_SUCCESS);
+        }
+        timer_armed_ = *expiration;
     }
 
     void flush_ring_wait_() noexcept {
         auto r = ring_.reap_completions_wait(
-            [this](io_uring_cqe *cqe) { process_cqe_(cqe); });
+            [this](io_uring_cqe *cqe) { process_cqe_(cqe); },
+            [](io_uring_cqe *cqe) { prefetch_cqe_(cqe); });
         if (r < 0) {
             panic_on(std::format("io_uring_submit_and_wait: {}",
                                  std::strerror(static_cast<int>(-r))));
         }
     }
 
+    static void prefetch_cqe_(io_uring_cqe *cqe) noexcept {
+        auto [data, type] = decode_work(io_uring_cqe_get_data64(cqe));
+        if (type == WorkType::Common) {
+            // Finish handles are spread around memory, load them early
+            __builtin_prefetch(data);
+        }
+    }
+
     void process_cqe_(io_uring_cqe *cqe) noexcept {
         auto [data, type] = decode_work(io_uring_cqe_get_data64(cqe));
 
@@ -438,17 +831,13 @@ private:
             // No-op
             assert(cqe->res != -EINVAL); // If EINVAL, something is wrong
         } else if (type == WorkType::Schedule) {
-            if (data == nullptr) {
-                if (cqe->res < 0) {
-                    panic_on(std::format("io_uring_prep_msg_ring: {}",
-                                         std::strerror(-cqe->res)));
-                }
-                pending_works_--;
-            } else {
-                auto *work = static_cast<WorkInvoker *>(data);
-                tsan_acquire(work);
-                (*work)();
+            // Completion of a msg_ring sent by this runtime
+            assert(data == nullptr);
+            if (cqe->res < 0) {
+                panic_on(std::format("io_uring_prep_msg_ring: {}",
+                                     std::strerror(-cqe->res)));
             }
+            local_pending_works_--;
         } else if (type == WorkType::Cancel) {
             detail::CancelRequest *request =
                 static_cast<detail::CancelRequest *>(data);
@@ -456,11 +845,19 @@ private:
             io_uring_sqe *sqe = ring_.get_sqe();
             prep_cancel_(sqe, request->data());
             request->notify();
+        } else if (type == WorkType::Timer) {
+            // Completion of the kernel timeout of the timer wheel
+            assert(data == nullptr);
+            timer_armed_.reset();
+            expire_timers_(timer_now_());
+            arm_timer_();
         } else if (type == WorkType::Common) {
             auto *handle = static_cast<OpFinishHandleBase *>(data);
+            budget_left_ = task_budget_;
+            detail::Context::current().set_priority(handle->priority());
             auto op_finish = handle->handle(cqe);
             if (op_finish) {
-                pending_works_--;
+                local_pending_works_--;
             }
         } else {
             unreachable();
@@ -479,22 +876,108 @@ private:
     using WorkListQueue =
         IntrusiveSingleList<WorkInvoker, &WorkInvoker::work_queue_entry_>;
 
-    // Global state
-    std::mutex mutex_;
-    WorkListQueue global_queue_;
-    std::atomic_size_t pending_works_ = 1;
+    using RemoteWorkQueue =
+        IntrusiveMpscList<WorkInvoker, &WorkInvoker::work_queue_entry_>;
+
+    // Global state, written by other threads
+    alignas(cache_line_size) RemoteWorkQueue remote_queue_;
+    std::atomic_bool sleeping_ = false;
+    std::atomic_size_t remote_pending_works_ = 1;
     std::atomic<State> state_ = State::Idle;
 
-    // Local state
-    WorkListQueue local_queue_;
+    // Shared state for work stealing
+    alignas(cache_line_size) std::mutex shared_mutex_;
+    WorkListQueue shared_queue_;
+    std::atomic_size_t shared_size_ = 0;
+    std::span<Runtime *const> peers_;
+    size_t peer_index_ = 0;
+    // Number of busy runtimes in the pool, see should_exit_()
+    std::atomic_size_t *pool_busy_ = nullptr;
+    bool pool_idle_ = false;
+
+    // Local state, only accessed by the runtime thread
+    alignas(cache_line_size) detail::RunQueue local_queue_;
+    size_t local_pending_works_ = 0;
     Ring ring_;
-    size_t tick_count_ = 0;
+    size_t ticks_until_flush_ = 0;
+    size_t budget_left_ = 0;
+    detail::BlockCache block_cache_;
+
+    std::optional<std::chrono::steady_clock::time_point> sq_pending_since_;
+
+    // Timers of the runtime, multiplexed onto a single kernel timeout
+    detail::TimerWheel timer_wheel_;
+    std::chrono::steady_clock::time_point timer_epoch_ =
+        std::chrono::steady_clock::now();
+    std::optional<uint64_t> timer_armed_;
+    __kernel_timespec timer_ts_ = {};
 
     // Configurable parameters
     size_t event_interval_ = 61;
+    bool adaptive_event_interval_ = false;
+    size_t min_event_interval_ = 0;
+    size_t max_event_interval_ = 0;
+    size_t submit_batch_ = 0;
+    std::chrono::nanoseconds submit_latency_{0};
+    bool enable_submit_on_tick_ = false;
+    size_t task_budget_ = 128;
+    std::chrono::nanoseconds busy_poll_{0};
+    bool disable_frame_cache_ = false;
     bool disable_register_ring_fd_ = false;
+
+    friend class RuntimePool;
+};
+
+namespace detail {
+
+/**
+ * @brief Forward the cancellation of an operation to its runtime thread.
+ * @details Some operations can only be cancelled in the thread of their
+ * runtime, such as timers of the timer wheel. Stop requests from other threads
+ * are forwarded by scheduling this work to the runtime. Owner provides
+ * cancel_local_(), which cancels the operation in the runtime thread, and
+ * finish_(), which completes the operation. If the operation finishes while a
+ * forwarded cancellation is in flight, finish_() is deferred until it runs, so
+ * that the owner outlives it.
+ */
+template <typename Owner>
+class ForwardedCancellation
+    : public InvokerAdapter<ForwardedCancellation<Owner>, WorkInvoker> {
+public:
+    // Called by the stop callback in other threads
+    void request(Owner *owner, Runtime *runtime) noexcept {
+        owner_ = owner;
+        pending_.store(true, std::memory_order_release);
+        runtime->schedule(this);
+    }
+
+    // Called in the runtime thread after the stop callback is reset. Return
+    // false if finish_() is deferred to the forwarded cancellation.
+    bool ready() noexcept {
+        if (!pending_.load(std::memory_order_acquire)) {
+            return true;
+        }
+        deferred_ = true;
+        return false;
+    }
+
+    void invoke() noexcept {
+        pending_.store(false, std::memory_order_relaxed);
+        if (deferred_) {
+            owner_->finish_();
+        } else {
+            owner_->cancel_local_();
+        }
+    }
+
+private:
+    Owner *owner_ = nullptr;
+    std::atomic_bool pending_ = false;
+    bool deferred_ = false;
 };
 
+} // namespace detail
+
 /**
  * @brief Get the current runtime.
  * @return Runtime& Reference to the current running runtime.
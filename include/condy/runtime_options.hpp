@@ -5,6 +5,7 @@
 #pragma once
 
 #include "condy/condy_uring.hpp"
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <optional>
@@ -35,6 +36,133 @@ public:
         return *this;
     }
 
+    /**
+     * @brief Enable adaptive event interval
+     * @details With this option, the runtime adjusts the event interval
+     * between min and max by itself. The interval is lowered when many
+     * completions are found at a check, to avoid CQ overflow, and raised when
+     * nothing is found while tasks are still ready to run, to avoid wasted
+     * checks. The value set by event_interval() is used as the initial value.
+     * @param min The minimum event interval
+     * @param max The maximum event interval
+     * @throws std::invalid_argument If min is zero or greater than max
+     */
+    Self &enable_adaptive_event_interval(size_t min = 1, size_t max = 1024) {
+        if (min == 0 || min > max) {
+            throw std::invalid_argument("Invalid adaptive event interval");
+        }
+        enable_adaptive_event_interval_ = true;
+        min_event_interval_ = min;
+        max_event_interval_ = max;
+        return *this;
+    }
+
+    /**
+     * @brief Set busy poll window
+     * @details By default, the runtime blocks in the kernel as soon as it has
+     * no task to run. With this option, it first spins for the given duration,
+     * polling the completion queue and the works scheduled from other
+     * threads, and only blocks if nothing arrives. This reduces wakeup latency
+     * at the cost of CPU time.
+     * @param v The busy poll window, 0 to disable
+     */
+    Self &busy_poll(std::chrono::nanoseconds v) {
+        busy_poll_ = v;
+        return *this;
+    }
+
+    /**
+     * @brief Set wait batch
+     * @details By default, the runtime wakes up as soon as one completion is
+     * ready when it blocks in the kernel. With this option, it wakes up when
+     * nr completions are ready, or when timeout has passed and at least one
+     * completion is ready. This reduces context switches for throughput
+     * oriented workloads, but may delay the handling of each completion
+     * (including works scheduled from other threads) by up to timeout.
+     * @param nr The number of completions to wait for
+     * @param timeout The maximum time to wait for more than one completion
+     * @throws std::invalid_argument If nr is zero, or timeout is zero while nr
+     * is greater than one
+     * @note Uses IORING_FEAT_MIN_TIMEOUT if supported, otherwise falls back to
+     * a timed wait followed by a plain wait if nothing completed.
+     */
+    Self &wait_batch(size_t nr, std::chrono::microseconds timeout) {
+        if (nr == 0 || (nr > 1 && timeout.count() == 0)) {
+            throw std::invalid_argument("Invalid wait batch");
+        }
+        wait_batch_nr_ = nr;
+        wait_batch_timeout_ = timeout;
+        return *this;
+    }
+
+    /**
+     * @brief Set submit batch
+     * @details By default, queued SQEs are only submitted when the runtime is
+     * about to wait for completions, or when the submission queue is full.
+     * With this option, the runtime submits as soon as at least v SQEs are
+     * queued, even if it still has tasks to run.
+     * @param v The number of queued SQEs that triggers a submission, 0 to
+     * disable
+     */
+    Self &submit_batch(size_t v) {
+        submit_batch_ = v;
+        return *this;
+    }
+
+    /**
+     * @brief Set submit latency
+     * @details With this option, the runtime submits queued SQEs once they
+     * have been queued for longer than the given duration, even if it still
+     * has tasks to run. The elapsed time is checked between two task
+     * resumptions, so the actual latency also depends on how long each task
+     * runs.
+     * @param v The maximum time SQEs can stay queued, 0 to disable
+     */
+    Self &submit_latency(std::chrono::nanoseconds v) {
+        submit_latency_ = v;
+        return *this;
+    }
+
+    /**
+     * @brief Set task budget
+     * @details Operations that complete synchronously, such as pushing to a
+     * channel that is not full, resume the awaiting coroutine without going
+     * back to the runtime. A coroutine whose operations keep completing this
+     * way could run forever and starve other tasks. With a budget, once a
+     * task has resumed synchronously v times in a row, its next synchronous
+     * completion is deferred to the back of the local queue instead.
+     * @param v The number of consecutive synchronous resumptions, 0 to
+     * disable
+     */
+    Self &task_budget(size_t v) {
+        task_budget_ = v;
+        return *this;
+    }
+
+    /**
+     * @brief Enable submit on tick
+     * @details With this option, the runtime submits queued SQEs every time it
+     * checks for completed events. See event_interval().
+     */
+    Self &enable_submit_on_tick() {
+        enable_submit_on_tick_ = true;
+        return *this;
+    }
+
+    /**
+     * @brief Disable frame cache
+     * @details By default, the runtime caches freed coroutine frames (of
+     * coroutines without custom allocator) in its own size-class free lists,
+     * and reuses them for new coroutines created in the runtime thread. The
+     * same cache also serves finish handles of zero-copy operations. This
+     * option disables the cache, so that they always use the global operator
+     * new and delete.
+     */
+    Self &disable_frame_cache() {
+        disable_frame_cache_ = true;
+        return *this;
+    }
+
     /**
      * @brief Disable register ring fd
      * @details By default, the runtime registers the ring file descriptor with
@@ -260,6 +388,17 @@ public:
 
 protected:
     size_t event_interval_ = 61;
+    bool enable_adaptive_event_interval_ = false;
+    size_t min_event_interval_ = 1;
+    size_t max_event_interval_ = 1024;
+    size_t submit_batch_ = 0; // 0 means disabled
+    std::chrono::nanoseconds submit_latency_{0}; // 0 means disabled
+    bool enable_submit_on_tick_ = false;
+    size_t task_budget_ = 128; // 0 means disabled
+    std::chrono::nanoseconds busy_poll_{0}; // 0 means disabled
+    size_t wait_batch_nr_ = 1;
+    std::chrono::microseconds wait_batch_timeout_{0};
+    bool disable_frame_cache_ = false;
     bool disable_register_ring_fd_ = false;
     bool enable_iopoll_ = false;
     bool enable_hybrid_iopoll_ = false;
@@ -0,0 +1,164 @@
+/**
+ * @file runtime_pool.hpp
+ * @brief Multi-threaded executor built on a group of runtimes.
+ * @details This file defines RuntimePool, which runs several Runtime instances
+ * on different threads and balances newly spawned tasks between them with work
+ * stealing.
+ */
+
+#pragma once
+
+#include "condy/context.hpp"
+#include "condy/coro.hpp"
+#include "condy/invoker.hpp"
+#include "condy/runtime.hpp"
+#include "condy/runtime_options.hpp"
+#include "condy/task.hpp"
+#include "condy/utils.hpp"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace condy {
+
+/**
+ * @brief A group of runtimes sharing spawned tasks by work stealing.
+ * @details Each runtime in the pool owns its io_uring instance and runs on its
+ * own thread. Tasks spawned into the pool are pushed to a shared queue of one
+ * runtime, from which any idle runtime in the pool can steal. Once a task
+ * starts running, it stays on the runtime that started it (unless it switches
+ * runtime explicitly by co_switch), since its pending I/O belongs to that
+ * runtime's ring.
+ */
+class RuntimePool {
+public:
+    /**
+     * @brief Construct a new RuntimePool object.
+     * @param num_runtimes Number of runtimes (and threads) in the pool.
+     * @param options Options used to create each runtime.
+     * @throws std::invalid_argument If num_runtimes is zero.
+     */
+    RuntimePool(size_t num_runtimes, const RuntimeOptions &options = {}) {
+        if (num_runtimes == 0) {
+            throw std::invalid_argument("RuntimePool requires at least one "
+                                        "runtime");
+        }
+        runtimes_.reserve(num_runtimes);
+        peers_.reserve(num_runtimes);
+        for (size_t i = 0; i < num_runtimes; i++) {
+            runtimes_.push_back(std::make_unique<Runtime>(options));
+            peers_.push_back(runtimes_.back().get());
+        }
+        busy_runtimes_.store(num_runtimes, std::memory_order_relaxed);
+        for (size_t i = 0; i < num_runtimes; i++) {
+            runtimes_[i]->peers_ = peers_;
+            runtimes_[i]->peer_index_ = i;
+            runtimes_[i]->pool_busy_ = &busy_runtimes_;
+        }
+    }
+
+    RuntimePool(const RuntimePool &) = delete;
+    RuntimePool &operator=(const RuntimePool &) = delete;
+    RuntimePool(RuntimePool &&) = delete;
+    RuntimePool &operator=(RuntimePool &&) = delete;
+
+public:
+    /**
+     * @brief Get the number of runtimes in the pool.
+     */
+    size_t size() const noexcept { return runtimes_.size(); }
+
+    /**
+     * @brief Get the runtime at the given index.
+     * @param index Index of the runtime, must be less than size().
+     */
+    Runtime &runtime(size_t index) noexcept { return *runtimes_[index]; }
+
+    /**
+     * @brief Allow all runtimes in the pool to exit when there are no pending
+     * works.
+     * @details Runtimes exit together, once none of them has pending works and
+     * no spawned task is left to steal.
+     * @note This function is thread-safe and can be called from any thread.
+     */
+    void allow_exit() noexcept {
+        for (auto &runtime : runtimes_) {
+            runtime->allow_exit();
+        }
+    }
+
+    /**
+     * @brief Schedule a work to the pool.
+     * @details If called from a runtime of the pool, the work is queued on
+     * that runtime and may be stolen by idle peers. Otherwise, the work is
+     * distributed to the runtimes in a round-robin manner.
+     * @note This function is thread-safe and can be called from any thread.
+     */
+    void schedule(WorkInvoker *work) noexcept {
+        auto *curr_runtime = detail::Context::current().runtime();
+        for (auto *runtime : peers_) {
+            if (runtime == curr_runtime) {
+                runtime->post_(work);
+                return;
+            }
+        }
+        size_t index = next_index_.fetch_add(1, std::memory_order_relaxed);
+        peers_[index % peers_.size()]->post_(work);
+    }
+
+    /**
+     * @brief Run all runtimes of the pool.
+     * @details The first runtime runs in the current thread, and each of the
+     * others runs in a new thread. This function returns after all runtimes
+     * have exited.
+     * @throw std::runtime_error If any runtime is already running or has been
+     * stopped.
+     */
+    void run() {
+        std::vector<std::thread> threads;
+        threads.reserve(runtimes_.size() - 1);
+        for (size_t i = 1; i < runtimes_.size(); i++) {
+            threads.emplace_back([runtime = runtimes_[i].get()] {
+                runtime->run();
+            });
+        }
+        auto join_all = defer([&] {
+            for (auto &thread : threads) {
+                thread.join();
+            }
+        });
+        runtimes_[0]->run();
+    }
+
+private:
+    std::vector<std::unique_ptr<Runtime>> runtimes_;
+    std::vector<Runtime *> peers_;
+    std::atomic_size_t next_index_ = 0;
+    std::atomic_size_t busy_runtimes_ = 0;
+};
+
+/**
+ * @brief Spawn a coroutine as a task in the given runtime pool.
+ * @tparam T Return type of the coroutine.
+ * @tparam Allocator Allocator type used for memory management.
+ * @param pool The runtime pool to spawn the task in.
+ * @param coro The coroutine to be spawned.
+ * @return Task<T, Allocator> The spawned task.
+ * @note The task may be started by any runtime of the pool.
+ */
+template <typename T, typename Allocator>
+inline Task<T, Allocator> co_spawn(RuntimePool &pool,
+                                   Coro<T, Allocator> coro) noexcept {
+    auto handle = coro.release();
+    auto &promise = handle.promise();
+    promise.set_priority(detail::Context::current().priority());
+    promise.mark_running();
+
+    pool.schedule(&promise);
+    return {handle};
+}
+
+} // namespace condy
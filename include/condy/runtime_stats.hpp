@@ -0,0 +1,82 @@
+/**
+ * @file runtime_stats.hpp
+ * @brief Statistics collected by a Runtime.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+namespace condy {
+
+/**
+ * @brief Statistics of a Runtime
+ * @details Counters are updated by the runtime thread without synchronization.
+ * Read them in the runtime thread, or after the runtime exits.
+ */
+struct RuntimeStats {
+    /**
+     * @brief Number of submissions that submitted at least one SQE.
+     */
+    size_t submits = 0;
+
+    /**
+     * @brief Total number of SQEs submitted.
+     */
+    size_t submitted_sqes = 0;
+
+    /**
+     * @brief Largest number of SQEs submitted at once.
+     */
+    size_t max_submit_batch = 0;
+
+    /**
+     * @brief Number of periodic completion checks. See
+     * RuntimeOptions::event_interval().
+     */
+    size_t event_checks = 0;
+
+    /**
+     * @brief Number of periodic completion checks that found no completion.
+     */
+    size_t empty_event_checks = 0;
+
+    /**
+     * @brief Number of times a task used up its budget and was deferred to
+     * the local queue. See RuntimeOptions::task_budget().
+     */
+    size_t budget_yields = 0;
+
+    /**
+     * @brief Number of busy-poll windows entered before parking. See
+     * RuntimeOptions::busy_poll().
+     */
+    size_t busy_polls = 0;
+
+    /**
+     * @brief Number of busy-poll windows in which new events arrived, so
+     * parking was avoided.
+     */
+    size_t busy_poll_hits = 0;
+
+    /**
+     * @brief Total time spent in busy-poll windows, i.e. CPU time burnt while
+     * idle.
+     */
+    std::chrono::nanoseconds busy_poll_time{0};
+
+    /**
+     * @brief Number of times the runtime blocked in the kernel waiting for
+     * completions.
+     */
+    size_t parks = 0;
+
+    /**
+     * @brief Total time spent blocked in the kernel, from the wait syscall
+     * until the runtime thread is woken up.
+     */
+    std::chrono::nanoseconds park_time{0};
+};
+
+} // namespace condy
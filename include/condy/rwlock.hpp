@@ -0,0 +1,304 @@
+/**
+ * @file rwlock.hpp
+ * @brief Asynchronous reader-writer lock for coroutines.
+ * @details This file defines an asynchronous reader-writer lock, which
+ * suspends awaiting coroutines instead of blocking threads, and can be used
+ * across different Runtimes.
+ */
+
+#pragma once
+
+#include "condy/context.hpp"
+#include "condy/intrusive.hpp"
+#include "condy/invoker.hpp"
+#include "condy/runtime.hpp"
+#include "condy/type_traits.hpp"
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+
+namespace condy {
+
+/**
+ * @brief Asynchronous reader-writer lock.
+ * @details The lock is either held exclusively by one writer, or shared by any
+ * number of readers. Awaiting lock operations are granted the lock in FIFO
+ * order: a shared lock operation waits behind an awaiting exclusive one, so
+ * writers are not starved by a stream of readers, and consecutive awaiting
+ * shared lock operations are granted the lock together. While no operation is
+ * awaiting, locking and unlocking only use atomic operations.
+ */
+class AsyncRWLock {
+public:
+    AsyncRWLock() = default;
+
+    AsyncRWLock(const AsyncRWLock &) = delete;
+    AsyncRWLock &operator=(const AsyncRWLock &) = delete;
+    AsyncRWLock(AsyncRWLock &&) = delete;
+    AsyncRWLock &operator=(AsyncRWLock &&) = delete;
+
+public:
+    /**
+     * @brief Try to lock exclusively without awaiting.
+     * @return true if the lock was acquired.
+     */
+    bool try_lock() noexcept { return try_lock_(true); }
+
+    /**
+     * @brief Try to lock shared without awaiting.
+     * @return true if the lock was acquired.
+     */
+    bool try_lock_shared() noexcept { return try_lock_(false); }
+
+    class [[nodiscard]] LockSender;
+    /**
+     * @brief Lock exclusively, awaiting if necessary.
+     * @return int32_t 0 if the lock was acquired; -ECANCELED if the operation
+     * was cancelled while waiting.
+     */
+    LockSender lock() noexcept;
+
+    /**
+     * @brief Lock shared, awaiting if necessary.
+     * @return int32_t 0 if the lock was acquired; -ECANCELED if the operation
+     * was cancelled while waiting.
+     */
+    LockSender lock_shared() noexcept;
+
+    /**
+     * @brief Unlock the exclusive lock.
+     */
+    void unlock() noexcept {
+        assert(state_.load(std::memory_order_relaxed) == writer_bit);
+        state_.store(0, std::memory_order_seq_cst);
+        wake_awaiters_();
+    }
+
+    /**
+     * @brief Unlock a shared lock.
+     */
+    void unlock_shared() noexcept {
+        [[maybe_unused]] auto state =
+            state_.fetch_sub(1, std::memory_order_seq_cst);
+        assert(state != 0 && !(state & writer_bit));
+        wake_awaiters_();
+    }
+
+private:
+    class LockFinishHandleBase : public WorkInvoker {
+    public:
+        LockFinishHandleBase(bool exclusive) : exclusive_(exclusive) {}
+
+        void schedule() noexcept {
+            assert(runtime_ != nullptr);
+            runtime_->schedule(this);
+        }
+
+        bool exclusive() const noexcept { return exclusive_; }
+
+        void set_result(int32_t result) noexcept { result_ = result; }
+
+    public:
+        DoubleLinkEntry link_entry_;
+
+    protected:
+        Runtime *runtime_ = nullptr;
+        bool exclusive_;
+        int32_t result_ = -ENOTRECOVERABLE; // Internal error if not set
+    };
+
+    template <typename Receiver> class LockFinishHandle;
+
+    bool try_lock_(bool exclusive) noexcept {
+        if (try_lock_fast_(exclusive)) [[likely]] {
+            return true;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        return waiters_.empty() && try_take_(exclusive);
+    }
+
+    int32_t request_lock_(LockFinishHandleBase *handle) noexcept {
+        if (try_lock_fast_(handle->exclusive())) [[likely]] {
+            return 0;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        // Count the awaiter before retrying, so that either the retry observes
+        // a concurrent unlock, or that unlock observes the awaiter.
+        awaiters_.fetch_add(1, std::memory_order_seq_cst);
+        if (waiters_.empty() && try_take_(handle->exclusive())) {
+            awaiters_.fetch_sub(1, std::memory_order_relaxed);
+            return 0;
+        }
+        waiters_.push_back(handle);
+        detail::Context::current().runtime()->pend_work();
+        return -EAGAIN;
+    }
+
+    bool cancel_lock_(LockFinishHandleBase *handle) noexcept {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (waiters_.remove(handle)) {
+            awaiters_.fetch_sub(1, std::memory_order_relaxed);
+            // Shared lock operations behind a cancelled exclusive one may
+            // proceed now
+            grant_awaiters_();
+            return true;
+        }
+        return false;
+    }
+
+private:
+    // Only taken when no operation is awaiting, so that the lock never goes to
+    // newcomers before awaiting operations.
+    bool try_lock_fast_(bool exclusive) noexcept {
+        if (awaiters_.load(std::memory_order_acquire) != 0) {
+            return false;
+        }
+        return try_take_(exclusive);
+    }
+
+    bool try_take_(bool exclusive) noexcept {
+        auto state = state_.load(std::memory_order_seq_cst);
+        if (exclusive) {
+            return state == 0 &&
+                   state_.compare_exchange_strong(state, writer_bit,
+                                                  std::memory_order_seq_cst);
+        }
+        while (!(state & writer_bit)) {
+            if (state_.compare_exchange_weak(state, state + 1,
+                                             std::memory_order_seq_cst)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void wake_awaiters_() noexcept {
+        if (awaiters_.load(std::memory_order_seq_cst) == 0) [[likely]] {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        grant_awaiters_();
+    }
+
+    void grant_awaiters_() noexcept {
+        LockFinishHandleBase *handle = nullptr;
+        while ((handle = waiters_.front()) != nullptr &&
+               try_take_(handle->exclusive())) {
+            waiters_.pop_front();
+            awaiters_.fetch_sub(1, std::memory_order_relaxed);
+            handle->set_result(0);
+            handle->schedule();
+        }
+    }
+
+private:
+    using HandleList = IntrusiveDoubleList<LockFinishHandleBase,
+                                           &LockFinishHandleBase::link_entry_>;
+
+    // Held exclusively if set, otherwise the number of readers
+    static constexpr size_t writer_bit = size_t(1)
+                                         << (sizeof(size_t) * 8 - 1);
+
+    std::mutex mutex_;
+    HandleList waiters_;
+    // Number of awaiting operations, including those being registered
+    std::atomic_size_t awaiters_ = 0;
+    std::atomic_size_t state_ = 0;
+};
+
+template <typename Receiver>
+class AsyncRWLock::LockFinishHandle
+    : public InvokerAdapter<LockFinishHandle<Receiver>, LockFinishHandleBase> {
+public:
+    using Base = InvokerAdapter<LockFinishHandle, LockFinishHandleBase>;
+
+    LockFinishHandle(AsyncRWLock &rwlock, bool exclusive, Receiver receiver)
+        : Base(exclusive), rwlock_(rwlock), receiver_(std::move(receiver)) {}
+
+    void start(Runtime *runtime) noexcept {
+        this->runtime_ = runtime;
+        this->set_priority(detail::Context::current().priority());
+        int32_t r = rwlock_.request_lock_(this);
+        if (r != -EAGAIN) {
+            std::move(receiver_)(r);
+            return;
+        }
+
+        auto stop_token = receiver_.get_stop_token();
+        if (stop_token.stop_possible()) {
+            stop_callback_.emplace(std::move(stop_token), Cancellation{this});
+        }
+    }
+
+    void invoke() noexcept {
+        stop_callback_.reset();
+        assert(this->runtime_ != nullptr);
+        this->runtime_->resume_work();
+        std::move(receiver_)(this->result_);
+    }
+
+private:
+    void cancel_() noexcept {
+        if (rwlock_.cancel_lock_(this)) {
+            // Successfully canceled
+            this->result_ = -ECANCELED;
+            assert(this->runtime_ != nullptr);
+            this->runtime_->schedule(this);
+        }
+    }
+
+    struct Cancellation {
+        LockFinishHandle *self;
+        void operator()() noexcept { self->cancel_(); }
+    };
+
+    using StopCallbackType =
+        stop_callback_t<stop_token_t<Receiver>, Cancellation>;
+
+private:
+    AsyncRWLock &rwlock_;
+    Receiver receiver_;
+    std::optional<StopCallbackType> stop_callback_;
+};
+
+class AsyncRWLock::LockSender {
+public:
+    using ReturnType = int32_t;
+
+    LockSender(AsyncRWLock &rwlock, bool exclusive)
+        : rwlock_(rwlock), exclusive_(exclusive) {}
+
+    template <typename Receiver> auto connect(Receiver receiver) noexcept {
+        return OperationState<Receiver>(rwlock_, exclusive_,
+                                        std::move(receiver));
+    }
+
+private:
+    template <typename Receiver>
+    class OperationState : public LockFinishHandle<Receiver> {
+    public:
+        using Base = LockFinishHandle<Receiver>;
+        using Base::Base;
+
+        void start(unsigned int /*flags*/) noexcept {
+            auto *runtime = detail::Context::current().runtime();
+            Base::start(runtime);
+        }
+    };
+
+    AsyncRWLock &rwlock_;
+    bool exclusive_;
+};
+
+inline AsyncRWLock::LockSender AsyncRWLock::lock() noexcept {
+    return {*this, true};
+}
+
+inline AsyncRWLock::LockSender AsyncRWLock::lock_shared() noexcept {
+    return {*this, false};
+}
+
+} // namespace condy
@@ -0,0 +1,271 @@
+/**
+ * @file select.hpp
+ * @brief Select over multiple channels.
+ * @details This file defines the select operation, which pops an item from
+ * whichever of several channels becomes ready first, with a single shared
+ * waiter instead of one pop operation per channel.
+ */
+
+#pragma once
+
+#include "condy/channel.hpp"
+#include "condy/context.hpp"
+#include "condy/invoker.hpp"
+#include "condy/runtime.hpp"
+#include "condy/type_traits.hpp"
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace condy {
+
+namespace detail {
+
+template <typename> struct is_channel : std::false_type {};
+
+template <typename T, size_t N>
+struct is_channel<Channel<T, N>> : std::true_type {};
+
+template <typename Receiver, typename... Channels> class SelectOperationState {
+public:
+    using ResultType =
+        std::variant<typename Channels::PopSender::ReturnType...>;
+
+    SelectOperationState(std::tuple<Channels &...> channels, Receiver receiver)
+        : SelectOperationState(channels, std::move(receiver),
+                               std::index_sequence_for<Channels...>{}) {}
+
+    SelectOperationState(SelectOperationState &&) = delete;
+    SelectOperationState &operator=(SelectOperationState &&) = delete;
+    SelectOperationState(const SelectOperationState &) = delete;
+    SelectOperationState &operator=(const SelectOperationState &) = delete;
+
+    void start(unsigned int /*flags*/) noexcept {
+        runtime_ = detail::Context::current().runtime();
+        start_(std::index_sequence_for<Channels...>{});
+    }
+
+private:
+    template <size_t I>
+    using channel_t = std::tuple_element_t<I, std::tuple<Channels...>>;
+
+    template <size_t I>
+    using result_t = typename channel_t<I>::PopSender::ReturnType;
+
+    template <size_t I>
+    class Handle
+        : public InvokerAdapter<Handle<I>,
+                                typename channel_t<I>::PopFinishHandleBase> {
+    public:
+        Handle(SelectOperationState *self) : self_(self) {}
+
+        void prepare(Runtime *runtime, std::atomic_bool *claim_flag) noexcept {
+            this->runtime_ = runtime;
+            this->set_priority(detail::Context::current().priority());
+            this->claim_flag_ = claim_flag;
+            registered_ = true;
+        }
+
+        // Whether the handle may still be linked by its channel
+        bool linked() const noexcept { return registered_ && !this->dropped(); }
+
+        void invoke() noexcept {
+            self_->template complete_<I>(std::move(this->result_));
+        }
+
+    private:
+        SelectOperationState *self_;
+        bool registered_ = false;
+    };
+
+    template <size_t... Is>
+    SelectOperationState(std::tuple<Channels &...> channels, Receiver receiver,
+                         std::index_sequence<Is...>)
+        : channels_(channels), receiver_(std::move(receiver)),
+          handles_(((void)Is, this)...) {}
+
+    template <size_t... Is> void start_(std::index_sequence<Is...>) noexcept {
+        std::optional<ResultType> result;
+        // Earlier channels take priority
+        if ((try_pop_fast_<Is>(result) || ...)) {
+            std::move(receiver_)(std::move(result.value()));
+            return;
+        }
+
+        // Register on one channel at a time, and stop as soon as the select
+        // is claimed, by this function or by a channel already registered on
+        runtime_->pend_work();
+        std::optional<ResultType> closed;
+        if (!(register_<Is>(result, closed) || ...) && closed.has_value() &&
+            !claimed_.exchange(true, std::memory_order_acq_rel)) {
+            // A closed channel only wins if no other channel has an item
+            result = std::move(closed);
+        }
+        if (result.has_value()) {
+            runtime_->resume_work();
+            unregister_(SIZE_MAX, std::index_sequence_for<Channels...>{});
+            std::move(receiver_)(std::move(result.value()));
+            return;
+        }
+
+        auto stop_token = receiver_.get_stop_token();
+        if (stop_token.stop_possible()) {
+            stop_callback_.emplace(std::move(stop_token), Cancellation{this});
+        }
+    }
+
+    template <size_t I>
+    bool try_pop_fast_(std::optional<ResultType> &result) noexcept {
+        auto item = std::get<I>(channels_).try_pop_fast_();
+        if (!item.has_value()) {
+            return false;
+        }
+        result.emplace(std::in_place_index<I>, 0, std::move(item.value()));
+        return true;
+    }
+
+    // Register the handle on a single channel, under its own lock. Return true
+    // if the select is claimed, with the result set if it is claimed here.
+    template <size_t I>
+    bool register_(std::optional<ResultType> &result,
+                   std::optional<ResultType> &closed) noexcept {
+        auto &channel = std::get<I>(channels_);
+        std::lock_guard lock(channel.mutex_);
+        std::optional<typename result_t<I>::second_type> item;
+        if (channel.register_awaiter_([&]() {
+                item = channel.try_pop_inner_();
+                return item.has_value();
+            })) {
+            if (!claimed_.exchange(true, std::memory_order_acq_rel)) {
+                result.emplace(std::in_place_index<I>, 0,
+                               std::move(item.value()));
+            } else if (!channel.complete_pop_awaiter_(
+                           std::move(item.value()))) {
+                // Claimed by another channel meanwhile, give the item back
+                channel.put_back_(std::move(item.value()));
+            }
+            return true;
+        }
+        if (channel.closed_.load(std::memory_order_relaxed)) {
+            channel.awaiters_.fetch_sub(1, std::memory_order_relaxed);
+            if (!closed.has_value()) {
+                closed.emplace(std::in_place_index<I>, -EPIPE,
+                               typename result_t<I>::second_type());
+            }
+        } else {
+            auto &handle = std::get<I>(handles_);
+            handle.prepare(runtime_, &claimed_);
+            channel.pop_awaiters_.push_back(&handle);
+        }
+        return claimed_.load(std::memory_order_acquire);
+    }
+
+    template <size_t I> void complete_(result_t<I> result) noexcept {
+        stop_callback_.reset();
+        runtime_->resume_work();
+        unregister_(cancelled_ ? SIZE_MAX : I,
+                    std::index_sequence_for<Channels...>{});
+        std::move(receiver_)(
+            ResultType(std::in_place_index<I>, std::move(result)));
+    }
+
+    // The winning handle has been removed by its channel, so only the losing
+    // ones are left to remove. Channels drop the losing handles they meet, and
+    // only those still linked need to take the lock of their channel. They
+    // can not be left to the channels, since they are owned by this object.
+    template <size_t... Is>
+    void unregister_(size_t winner, std::index_sequence<Is...>) noexcept {
+        ((Is != winner && std::get<Is>(handles_).linked()
+              ? (void)std::get<Is>(channels_).cancel_pop_(
+                    &std::get<Is>(handles_))
+              : (void)0),
+         ...);
+    }
+
+    void cancel_() noexcept {
+        if (claimed_.exchange(true, std::memory_order_acq_rel)) {
+            // Already completed by a channel
+            return;
+        }
+        cancelled_ = true;
+        auto &handle = std::get<0>(handles_);
+        handle.set_result({-ECANCELED, typename result_t<0>::second_type()});
+        handle.schedule();
+    }
+
+    struct Cancellation {
+        SelectOperationState *self;
+        void operator()() noexcept { self->cancel_(); }
+    };
+
+    using StopCallbackType =
+        stop_callback_t<stop_token_t<Receiver>, Cancellation>;
+
+    template <typename T> struct handles_traits;
+    template <size_t... Is> struct handles_traits<std::index_sequence<Is...>> {
+        using type = std::tuple<Handle<Is>...>;
+    };
+
+    using HandlesType =
+        typename handles_traits<std::index_sequence_for<Channels...>>::type;
+
+private:
+    std::tuple<Channels &...> channels_;
+    Receiver receiver_;
+    Runtime *runtime_ = nullptr;
+    HandlesType handles_;
+    // Shared by all handles, set by whoever completes the select first
+    std::atomic_bool claimed_ = false;
+    bool cancelled_ = false;
+    std::optional<StopCallbackType> stop_callback_;
+};
+
+} // namespace detail
+
+template <typename... Channels> class [[nodiscard]] SelectSender {
+public:
+    using ReturnType =
+        std::variant<typename Channels::PopSender::ReturnType...>;
+
+    SelectSender(Channels &...channels) : channels_(channels...) {}
+
+    template <typename Receiver> auto connect(Receiver receiver) noexcept {
+        return detail::SelectOperationState<Receiver, Channels...>(
+            channels_, std::move(receiver));
+    }
+
+private:
+    std::tuple<Channels &...> channels_;
+};
+
+/**
+ * @brief Pop an item from whichever of the channels is ready first.
+ * @param channels The channels to pop from. They must be distinct.
+ * @return std::variant<std::pair<int32_t, T>...> The index of the variant is
+ * the index of the channel that completed the operation, and the pair is the
+ * same as the result of Channel::pop(). If the operation is cancelled while
+ * waiting, -ECANCELED is reported as the result of the first channel.
+ * @details This is equivalent to `when_any(channels.pop()...)`, but waits with
+ * a single waiter shared by all channels. The first channel ready to complete
+ * it claims the waiter, and the registrations on the other channels are
+ * removed without scheduling any cancellation. If several channels are ready
+ * when the operation starts, earlier channels take priority, and a closed
+ * channel only completes the operation if no other channel has an item.
+ */
+template <typename... Channels>
+SelectSender<Channels...> select(Channels &...channels) {
+    static_assert(sizeof...(Channels) > 0,
+                  "select requires at least one channel");
+    static_assert((detail::is_channel<Channels>::value && ...),
+                  "select only supports condy::Channel");
+    return SelectSender<Channels...>(channels...);
+}
+
+} // namespace condy
@@ -0,0 +1,299 @@
+/**
+ * @file semaphore.hpp
+ * @brief Asynchronous semaphore and mutex for coroutines.
+ * @details This file defines an asynchronous counting semaphore and mutex,
+ * which suspend awaiting coroutines instead of blocking threads, and can be
+ * used across different Runtimes.
+ */
+
+#pragma once
+
+#include "condy/context.hpp"
+#include "condy/intrusive.hpp"
+#include "condy/invoker.hpp"
+#include "condy/runtime.hpp"
+#include "condy/type_traits.hpp"
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+
+namespace condy {
+
+/**
+ * @brief Asynchronous counting semaphore.
+ * @details Awaiting acquire operations are granted permits in FIFO order, and
+ * a released permit is handed over to the first of them directly, so no
+ * awaiting coroutine is woken up just to find the permit taken. While no
+ * operation is awaiting, acquire and release only use atomic operations. The
+ * internal lock is only used to register and wake awaiting operations.
+ */
+class AsyncSemaphore {
+public:
+    /**
+     * @brief Construct a new AsyncSemaphore object
+     * @param permits Number of initially available permits.
+     */
+    AsyncSemaphore(size_t permits) : permits_(permits) {}
+
+    AsyncSemaphore(const AsyncSemaphore &) = delete;
+    AsyncSemaphore &operator=(const AsyncSemaphore &) = delete;
+    AsyncSemaphore(AsyncSemaphore &&) = delete;
+    AsyncSemaphore &operator=(AsyncSemaphore &&) = delete;
+
+public:
+    /**
+     * @brief Try to acquire a permit without awaiting.
+     * @return true if a permit was acquired.
+     */
+    bool try_acquire() noexcept {
+        if (try_acquire_fast_()) [[likely]] {
+            return true;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        return waiters_.empty() && try_take_permit_();
+    }
+
+    class [[nodiscard]] AcquireSender;
+    /**
+     * @brief Acquire a permit, awaiting if necessary.
+     * @return int32_t 0 if a permit was acquired; -ECANCELED if the operation
+     * was cancelled while waiting.
+     */
+    AcquireSender acquire() noexcept;
+
+    /**
+     * @brief Release permits, handing them over to awaiting operations first.
+     * @param n Number of permits to release.
+     * @note This function is thread-safe and can be called from any thread.
+     */
+    void release(size_t n = 1) noexcept {
+        permits_.fetch_add(n, std::memory_order_seq_cst);
+        if (awaiters_.load(std::memory_order_seq_cst) == 0) [[likely]] {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        WaitFinishHandleBase *handle = nullptr;
+        while ((handle = waiters_.front()) != nullptr && try_take_permit_()) {
+            waiters_.pop_front();
+            awaiters_.fetch_sub(1, std::memory_order_relaxed);
+            handle->set_result(0);
+            handle->schedule();
+        }
+    }
+
+    /**
+     * @brief Get the number of available permits.
+     * @warning This function may not be accurate in multithreaded scenarios.
+     */
+    size_t available() const noexcept {
+        return permits_.load(std::memory_order_relaxed);
+    }
+
+private:
+    class WaitFinishHandleBase : public WorkInvoker {
+    public:
+        void schedule() noexcept {
+            assert(runtime_ != nullptr);
+            runtime_->schedule(this);
+        }
+
+        void set_result(int32_t result) noexcept { result_ = result; }
+
+    public:
+        DoubleLinkEntry link_entry_;
+
+    protected:
+        Runtime *runtime_ = nullptr;
+        int32_t result_ = -ENOTRECOVERABLE; // Internal error if not set
+    };
+
+    template <typename Receiver> class WaitFinishHandle;
+
+    int32_t request_acquire_(WaitFinishHandleBase *handle) noexcept {
+        if (try_acquire_fast_()) [[likely]] {
+            return 0;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        // Count the awaiter before retrying, so that either the retry observes
+        // a concurrent release, or that release observes the awaiter.
+        awaiters_.fetch_add(1, std::memory_order_seq_cst);
+        if (waiters_.empty() && try_take_permit_()) {
+            awaiters_.fetch_sub(1, std::memory_order_relaxed);
+            return 0;
+        }
+        waiters_.push_back(handle);
+        detail::Context::current().runtime()->pend_work();
+        return -EAGAIN;
+    }
+
+    bool cancel_acquire_(WaitFinishHandleBase *handle) noexcept {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (waiters_.remove(handle)) {
+            awaiters_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+private:
+    // Only taken when no operation is awaiting, so that permits never go to
+    // newcomers before awaiting operations.
+    bool try_acquire_fast_() noexcept {
+        if (awaiters_.load(std::memory_order_acquire) != 0) {
+            return false;
+        }
+        return try_take_permit_();
+    }
+
+    bool try_take_permit_() noexcept {
+        auto permits = permits_.load(std::memory_order_seq_cst);
+        while (permits > 0) {
+            if (permits_.compare_exchange_weak(permits, permits - 1,
+                                               std::memory_order_seq_cst)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    using HandleList = IntrusiveDoubleList<WaitFinishHandleBase,
+                                           &WaitFinishHandleBase::link_entry_>;
+
+    std::mutex mutex_;
+    HandleList waiters_;
+    // Number of awaiting operations, including those being registered
+    std::atomic_size_t awaiters_ = 0;
+    std::atomic_size_t permits_;
+};
+
+template <typename Receiver>
+class AsyncSemaphore::WaitFinishHandle
+    : public InvokerAdapter<WaitFinishHandle<Receiver>, WaitFinishHandleBase> {
+public:
+    WaitFinishHandle(AsyncSemaphore &semaphore, Receiver receiver)
+        : semaphore_(semaphore), receiver_(std::move(receiver)) {}
+
+    void start(Runtime *runtime) noexcept {
+        this->runtime_ = runtime;
+        this->set_priority(detail::Context::current().priority());
+        int32_t r = semaphore_.request_acquire_(this);
+        if (r != -EAGAIN) {
+            std::move(receiver_)(r);
+            return;
+        }
+
+        auto stop_token = receiver_.get_stop_token();
+        if (stop_token.stop_possible()) {
+            stop_callback_.emplace(std::move(stop_token), Cancellation{this});
+        }
+    }
+
+    void invoke() noexcept {
+        stop_callback_.reset();
+        assert(this->runtime_ != nullptr);
+        this->runtime_->resume_work();
+        std::move(receiver_)(this->result_);
+    }
+
+private:
+    void cancel_() noexcept {
+        if (semaphore_.cancel_acquire_(this)) {
+            // Successfully canceled
+            this->result_ = -ECANCELED;
+            assert(this->runtime_ != nullptr);
+            this->runtime_->schedule(this);
+        }
+    }
+
+    struct Cancellation {
+        WaitFinishHandle *self;
+        void operator()() noexcept { self->cancel_(); }
+    };
+
+    using StopCallbackType =
+        stop_callback_t<stop_token_t<Receiver>, Cancellation>;
+
+private:
+    AsyncSemaphore &semaphore_;
+    Receiver receiver_;
+    std::optional<StopCallbackType> stop_callback_;
+};
+
+class AsyncSemaphore::AcquireSender {
+public:
+    using ReturnType = int32_t;
+
+    AcquireSender(AsyncSemaphore &semaphore) : semaphore_(semaphore) {}
+
+    template <typename Receiver> auto connect(Receiver receiver) noexcept {
+        return OperationState<Receiver>(semaphore_, std::move(receiver));
+    }
+
+private:
+    template <typename Receiver>
+    class OperationState : public WaitFinishHandle<Receiver> {
+    public:
+        using Base = WaitFinishHandle<Receiver>;
+        using Base::Base;
+
+        void start(unsigned int /*flags*/) noexcept {
+            auto *runtime = detail::Context::current().runtime();
+            Base::start(runtime);
+        }
+    };
+
+    AsyncSemaphore &semaphore_;
+};
+
+inline AsyncSemaphore::AcquireSender AsyncSemaphore::acquire() noexcept {
+    return {*this};
+}
+
+/**
+ * @brief Asynchronous mutex.
+ * @details A mutex is a semaphore with a single permit, so it has the same
+ * properties as condy::AsyncSemaphore: the lock is handed over to awaiting
+ * operations in FIFO order, and uncontended locking only uses atomic
+ * operations. The mutex is not owned by a thread or a coroutine, and may be
+ * unlocked from any of them.
+ */
+class AsyncMutex {
+public:
+    AsyncMutex() = default;
+
+    AsyncMutex(const AsyncMutex &) = delete;
+    AsyncMutex &operator=(const AsyncMutex &) = delete;
+    AsyncMutex(AsyncMutex &&) = delete;
+    AsyncMutex &operator=(AsyncMutex &&) = delete;
+
+public:
+    /**
+     * @brief Try to lock the mutex without awaiting.
+     * @return true if the mutex was locked.
+     */
+    bool try_lock() noexcept { return semaphore_.try_acquire(); }
+
+    /**
+     * @brief Lock the mutex, awaiting if necessary.
+     * @return int32_t 0 if the mutex was locked; -ECANCELED if the operation
+     * was cancelled while waiting.
+     */
+    AsyncSemaphore::AcquireSender lock() noexcept {
+        return semaphore_.acquire();
+    }
+
+    /**
+     * @brief Unlock the mutex, handing it over to the first awaiting lock
+     * operation, if any.
+     */
+    void unlock() noexcept { semaphore_.release(); }
+
+private:
+    AsyncSemaphore semaphore_{1};
+};
+
+} // namespace condy
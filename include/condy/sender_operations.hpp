@@ -6,7 +6,10 @@
 #pragma once
 
 #include "condy/concepts.hpp"
+#include "condy/context.hpp"
+#include "condy/runtime.hpp"
 #include "condy/senders.hpp"
+#include <chrono>
 #include <coroutine>
 
 namespace condy {
@@ -72,8 +75,15 @@ public:
     bool await_suspend(std::coroutine_handle<Promise> h) noexcept {
         operation_state_.start(0);
         if (handle_ == std::noop_coroutine()) {
-            // The operation completed synchronously, no need to suspend
-            return false;
+            // The operation completed synchronously, no need to suspend,
+            // unless the task has used up its budget
+            auto *runtime = detail::Context::current().runtime();
+            if (runtime->consume_budget()) {
+                return false;
+            }
+            h.promise().set_priority(detail::Context::current().priority());
+            runtime->schedule_local(&h.promise());
+            return true;
         } else {
             handle_ = h;
             return true;
@@ -140,6 +150,39 @@ template <typename Sender> auto always_async(Sender &&sender) {
     return flag<IOSQE_ASYNC>(std::forward<Sender>(sender));
 }
 
+/**
+ * @brief Cancel an operation if it does not complete before the deadline.
+ * @details If the operation is a single io_uring operation, it is linked with
+ * an IORING_OP_LINK_TIMEOUT, so the kernel cancels it on time without any
+ * extra round trip. Otherwise, e.g. for composed operations, a timer of the
+ * runtime requests the operation to stop at the deadline.
+ * @param sender The operation to apply the deadline to.
+ * @param deadline The time point the operation must complete before.
+ * @return The result of the operation, which is usually -ECANCELED if it is
+ * cancelled on timeout.
+ */
+template <typename Sender>
+auto with_deadline(Sender &&sender,
+                   std::chrono::steady_clock::time_point deadline) {
+    return TimeoutSender<std::decay_t<Sender>>(std::forward<Sender>(sender),
+                                               deadline);
+}
+
+/**
+ * @brief Cancel an operation if it does not complete within the timeout.
+ * @details See condy::with_deadline().
+ * @param sender The operation to apply the timeout to.
+ * @param timeout The duration the operation must complete within, measured
+ * from the call.
+ */
+template <typename Sender, typename Rep, typename Period>
+auto with_timeout(Sender &&sender, std::chrono::duration<Rep, Period> timeout) {
+    return with_deadline(
+        std::forward<Sender>(sender),
+        std::chrono::steady_clock::now() +
+            std::chrono::ceil<std::chrono::steady_clock::duration>(timeout));
+}
+
 /**
  * @brief Compose multiple operations into a single sender that executes them in
  * parallel.
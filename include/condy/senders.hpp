@@ -8,6 +8,7 @@
 #include "condy/concepts.hpp"
 #include "condy/op_states.hpp"
 #include <array>
+#include <chrono>
 #include <stdexcept>
 #include <tuple>
 #include <type_traits>
@@ -201,6 +202,44 @@ using LinkSender = LinkSenderBase<IOSQE_IO_LINK, Senders...>;
 template <typename... Senders>
 using HardLinkSender = LinkSenderBase<IOSQE_IO_HARDLINK, Senders...>;
 
+namespace detail {
+
+// Senders that prepare exactly one SQE, which a linked timeout can follow
+template <typename Sender> struct is_single_op_sender : std::false_type {};
+
+template <PrepFuncLike PrepFunc, CQEHandlerLike CQEHandler>
+struct is_single_op_sender<OpSender<PrepFunc, CQEHandler>> : std::true_type {};
+
+template <unsigned int Flags, typename Sender>
+struct is_single_op_sender<FlaggedOpSender<Flags, Sender>>
+    : is_single_op_sender<Sender> {};
+
+} // namespace detail
+
+template <typename Sender> class TimeoutSender {
+public:
+    using ReturnType = typename Sender::ReturnType;
+
+    TimeoutSender(Sender sender, std::chrono::steady_clock::time_point deadline)
+        : sender_(std::move(sender)), deadline_(deadline) {}
+
+    template <typename Receiver> auto connect(Receiver receiver) noexcept {
+        if constexpr (detail::is_single_op_sender<Sender>::value) {
+            return detail::LinkTimeoutOperationState<Sender, Receiver>(
+                std::move(sender_), deadline_, std::move(receiver));
+        } else {
+            return detail::TimerTimeoutOperationState<Receiver, Sender>(
+                std::make_tuple(std::move(sender_),
+                                detail::SleepSender(deadline_)),
+                std::move(receiver));
+        }
+    }
+
+private:
+    Sender sender_;
+    std::chrono::steady_clock::time_point deadline_;
+};
+
 template <typename Sender> class RangedParallelAllSender {
 public:
     using ReturnType = std::pair<std::vector<size_t>,
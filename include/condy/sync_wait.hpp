@@ -7,6 +7,7 @@
 
 #include "condy/coro.hpp"
 #include "condy/runtime.hpp"
+#include "condy/runtime_pool.hpp"
 #include "condy/task.hpp"
 
 namespace condy {
@@ -28,6 +29,24 @@ T sync_wait(Runtime &runtime, Coro<T, Allocator> coro) {
     return t.wait();
 }
 
+/**
+ * @brief Synchronously wait for a coroutine to complete in the given runtime
+ * pool.
+ * @tparam T Type of the coroutine result.
+ * @tparam Allocator Allocator type used for memory management.
+ * @param pool The runtime pool to run the coroutine in.
+ * @param coro The coroutine to be run.
+ * @return T The result of the coroutine.
+ * @note This function will exit after all coroutines are completed.
+ */
+template <typename T, typename Allocator>
+T sync_wait(RuntimePool &pool, Coro<T, Allocator> coro) {
+    auto t = co_spawn(pool, std::move(coro));
+    pool.allow_exit();
+    pool.run();
+    return t.wait();
+}
+
 /**
  * @brief Get the default runtime options. This options will be used when
  * using sync_wait without specifying runtime.
@@ -10,6 +10,7 @@
 #include "condy/context.hpp"
 #include "condy/coro.hpp"
 #include "condy/invoker.hpp"
+#include "condy/priority.hpp"
 #include "condy/runtime.hpp"
 #include <coroutine>
 #include <exception>
@@ -198,6 +199,7 @@ struct TaskAwaiterBase : public InvokerAdapter<TaskAwaiterBase<T, Allocator>> {
         detail::Context::current().runtime()->pend_work();
         assert(runtime_ != nullptr);
         caller_promise_ = &caller_handle.promise();
+        caller_promise_->set_priority(detail::Context::current().priority());
         return task_handle_.promise().request_join(this);
     }
 
@@ -260,13 +262,47 @@ inline auto TaskBase<T, Allocator>::operator co_await() noexcept {
  * @return Task<T, Allocator> The spawned task.
  * @details This function schedules the given coroutine to run as a task in the
  * specified runtime. The coroutine will be executed concurrently in the
- * runtime.
+ * runtime. The task inherits the priority of the spawning task.
  */
 template <typename T, typename Allocator>
 inline Task<T, Allocator> co_spawn(Runtime &runtime,
                                    Coro<T, Allocator> coro) noexcept {
+    return co_spawn(runtime, std::move(coro),
+                    detail::Context::current().priority());
+}
+
+/**
+ * @brief Spawn a coroutine as a task in the current runtime.
+ * @tparam T Return type of the coroutine.
+ * @tparam Allocator Allocator type used for memory management.
+ * @param coro The coroutine to be spawned.
+ * @return Task<T, Allocator> The spawned task.
+ * @throws std::logic_error If there is no current runtime.
+ */
+template <typename T, typename Allocator>
+inline Task<T, Allocator> co_spawn(Coro<T, Allocator> coro) {
+    auto *runtime = detail::Context::current().runtime();
+    if (runtime == nullptr) [[unlikely]] {
+        throw std::logic_error("No runtime to spawn coroutine task");
+    }
+    return co_spawn(*runtime, std::move(coro));
+}
+
+/**
+ * @brief Spawn a coroutine as a task with the given priority.
+ * @param runtime The runtime to spawn the coroutine in.
+ * @param coro The coroutine to be spawned.
+ * @param priority The priority of the task. Tasks spawned without a priority
+ * inherit the priority of the spawning task, or TaskPriority::Normal outside
+ * of tasks.
+ * @return Task<T, Allocator> The spawned task.
+ */
+template <typename T, typename Allocator>
+inline Task<T, Allocator> co_spawn(Runtime &runtime, Coro<T, Allocator> coro,
+                                   TaskPriority priority) noexcept {
     auto handle = coro.release();
     auto &promise = handle.promise();
+    promise.set_priority(priority);
     promise.mark_running();
 
     runtime.schedule(&promise);
@@ -274,20 +310,21 @@ inline Task<T, Allocator> co_spawn(Runtime &runtime,
 }
 
 /**
- * @brief Spawn a coroutine as a task in the current runtime.
- * @tparam T Return type of the coroutine.
- * @tparam Allocator Allocator type used for memory management.
+ * @brief Spawn a coroutine as a task with the given priority in the current
+ * runtime.
  * @param coro The coroutine to be spawned.
+ * @param priority The priority of the task.
  * @return Task<T, Allocator> The spawned task.
  * @throws std::logic_error If there is no current runtime.
  */
 template <typename T, typename Allocator>
-inline Task<T, Allocator> co_spawn(Coro<T, Allocator> coro) {
+inline Task<T, Allocator> co_spawn(Coro<T, Allocator> coro,
+                                   TaskPriority priority) {
     auto *runtime = detail::Context::current().runtime();
     if (runtime == nullptr) [[unlikely]] {
         throw std::logic_error("No runtime to spawn coroutine task");
     }
-    return co_spawn(*runtime, std::move(coro));
+    return co_spawn(*runtime, std::move(coro), priority);
 }
 
 namespace detail {
@@ -297,6 +334,7 @@ struct [[nodiscard]] SwitchAwaiter {
 
     template <typename PromiseType>
     void await_suspend(std::coroutine_handle<PromiseType> handle) noexcept {
+        handle.promise().set_priority(detail::Context::current().priority());
         runtime_->schedule(&handle.promise());
     }
 
@@ -319,4 +357,15 @@ inline detail::SwitchAwaiter co_switch(Runtime &runtime) noexcept {
     return {&runtime};
 }
 
+/**
+ * @brief Yield the current coroutine task to other tasks of the runtime.
+ * @return detail::SwitchAwaiter Awaiter object for the yield operation.
+ * @details This function reschedules the caller coroutine to the back of the
+ * local queue of the current runtime, without submitting any operation. Use
+ * it in long computations to let other tasks run in between.
+ */
+inline detail::SwitchAwaiter yield_now() noexcept {
+    return {detail::Context::current().runtime()};
+}
+
 } // namespace condy
\ No newline at end of file
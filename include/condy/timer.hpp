@@ -0,0 +1,157 @@
+/**
+ * @file timer.hpp
+ * @brief Timers backed by the timer wheel of the runtime.
+ * @details This file defines condy::async_sleep() and
+ * condy::async_sleep_until(). Unlike condy::async_timeout(), they do not
+ * submit a timeout to the kernel each. All timers of a runtime are kept in a
+ * userspace timer wheel, which arms a single kernel timeout for the earliest
+ * deadline, and cancelling them never touches the ring. Stop requests from
+ * other threads are forwarded to the runtime thread.
+ */
+
+#pragma once
+
+#include "condy/context.hpp"
+#include "condy/invoker.hpp"
+#include "condy/runtime.hpp"
+#include "condy/timer_wheel.hpp"
+#include "condy/type_traits.hpp"
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+namespace condy {
+
+namespace detail {
+
+template <typename Receiver>
+class SleepFinishHandle
+    : public InvokerAdapter<SleepFinishHandle<Receiver>, TimerHandle> {
+public:
+    SleepFinishHandle(std::chrono::steady_clock::time_point deadline,
+                      Receiver receiver)
+        : until_(deadline), receiver_(std::move(receiver)) {}
+
+    void start(Runtime *runtime) noexcept {
+        runtime_ = runtime;
+        this->set_priority(detail::Context::current().priority());
+        if (!runtime->add_timer(this, until_)) {
+            std::move(receiver_)(-ETIME);
+            return;
+        }
+        runtime->pend_work();
+
+        auto stop_token = receiver_.get_stop_token();
+        if (stop_token.stop_possible()) {
+            stop_callback_.emplace(std::move(stop_token), Cancellation{this});
+        }
+    }
+
+    void invoke() noexcept {
+        stop_callback_.reset();
+        if (forwarded_cancel_.ready()) {
+            finish_();
+        }
+    }
+
+private:
+    friend class ForwardedCancellation<SleepFinishHandle>;
+
+    void finish_() noexcept {
+        assert(runtime_ != nullptr);
+        runtime_->resume_work();
+        std::move(receiver_)(result_);
+    }
+
+    void cancel_() noexcept {
+        // The timer wheel belongs to the runtime thread
+        if (detail::Context::current().runtime() != runtime_) {
+            forwarded_cancel_.request(this, runtime_);
+            return;
+        }
+        cancel_local_();
+    }
+
+    void cancel_local_() noexcept {
+        if (runtime_->cancel_timer(this)) {
+            // Successfully canceled
+            result_ = -ECANCELED;
+            runtime_->schedule_local(this);
+        }
+    }
+
+    struct Cancellation {
+        SleepFinishHandle *self;
+        void operator()() noexcept { self->cancel_(); }
+    };
+
+    using StopCallbackType =
+        stop_callback_t<stop_token_t<Receiver>, Cancellation>;
+
+private:
+    Runtime *runtime_ = nullptr;
+    std::chrono::steady_clock::time_point until_;
+    int32_t result_ = -ETIME;
+    Receiver receiver_;
+    std::optional<StopCallbackType> stop_callback_;
+    ForwardedCancellation<SleepFinishHandle> forwarded_cancel_;
+};
+
+class [[nodiscard]] SleepSender {
+public:
+    using ReturnType = int32_t;
+
+    SleepSender(std::chrono::steady_clock::time_point deadline)
+        : deadline_(deadline) {}
+
+    template <typename Receiver> auto connect(Receiver receiver) noexcept {
+        return OperationState<Receiver>(deadline_, std::move(receiver));
+    }
+
+private:
+    template <typename Receiver>
+    class OperationState : public SleepFinishHandle<Receiver> {
+    public:
+        using Base = SleepFinishHandle<Receiver>;
+        using Base::Base;
+
+        void start(unsigned int /*flags*/) noexcept {
+            auto *runtime = detail::Context::current().runtime();
+            Base::start(runtime);
+        }
+    };
+
+    std::chrono::steady_clock::time_point deadline_;
+};
+
+} // namespace detail
+
+/**
+ * @brief Sleep until the deadline.
+ * @param deadline The time point to sleep until. Timers have a granularity of
+ * one millisecond, and never expire before the deadline.
+ * @return int32_t -ETIME if the deadline is reached; -ECANCELED if the sleep
+ * is cancelled before the deadline. This matches condy::async_timeout(), so
+ * that the two are interchangeable.
+ */
+inline detail::SleepSender
+async_sleep_until(std::chrono::steady_clock::time_point deadline) noexcept {
+    return {deadline};
+}
+
+/**
+ * @brief Sleep for the duration.
+ * @param duration The duration to sleep for, measured from the call.
+ * @return int32_t -ETIME if the duration has elapsed; -ECANCELED if the sleep
+ * is cancelled before that.
+ */
+template <typename Rep, typename Period>
+inline detail::SleepSender
+async_sleep(std::chrono::duration<Rep, Period> duration) noexcept {
+    return async_sleep_until(
+        std::chrono::steady_clock::now() +
+        std::chrono::ceil<std::chrono::steady_clock::duration>(duration));
+}
+
+} // namespace condy
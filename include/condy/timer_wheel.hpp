@@ -0,0 +1,211 @@
+/**
+ * @file timer_wheel.hpp
+ * @brief Hierarchical timer wheel for runtime timers.
+ * @details This file defines the timer wheel used by condy::Runtime to
+ * multiplex all timers of a runtime onto a single kernel timeout.
+ */
+
+#pragma once
+
+#include "condy/intrusive.hpp"
+#include "condy/invoker.hpp"
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace condy {
+
+namespace detail {
+
+/**
+ * @brief Timer registered in a TimerWheel.
+ */
+class TimerHandle : public WorkInvoker {
+public:
+    uint64_t deadline() const noexcept { return deadline_; }
+
+public:
+    DoubleLinkEntry link_entry_;
+
+protected:
+    friend class TimerWheel;
+
+    uint64_t deadline_ = 0;
+    uint32_t slot_ = 0;
+};
+
+/**
+ * @brief Hierarchical timer wheel.
+ * @details Deadlines are measured in ticks. Each level has 64 slots, and each
+ * slot of a level spans all slots of the level below, so six levels cover
+ * 2^36 ticks. Timers far away sit in coarse slots and are moved down as time
+ * advances. Inserting and removing a timer are O(1), and the next expiration
+ * is found with one bitmap scan per level.
+ */
+class TimerWheel {
+public:
+    TimerWheel() = default;
+
+    TimerWheel(const TimerWheel &) = delete;
+    TimerWheel &operator=(const TimerWheel &) = delete;
+    TimerWheel(TimerWheel &&) = delete;
+    TimerWheel &operator=(TimerWheel &&) = delete;
+
+public:
+    bool empty() const noexcept { return size_ == 0; }
+
+    size_t size() const noexcept { return size_; }
+
+    /**
+     * @brief Current time of the wheel, timers at or before it have expired.
+     */
+    uint64_t elapsed() const noexcept { return elapsed_; }
+
+    /**
+     * @brief Insert a timer expiring at the deadline.
+     * @return false if the deadline has already passed, in which case the
+     * timer is not inserted.
+     */
+    bool insert(TimerHandle *handle, uint64_t deadline) noexcept {
+        if (deadline <= elapsed_) {
+            return false;
+        }
+        handle->deadline_ = deadline;
+        insert_(handle);
+        size_++;
+        return true;
+    }
+
+    /**
+     * @brief Remove the timer if it has not expired yet.
+     * @return true if the timer was removed.
+     */
+    bool remove(TimerHandle *handle) noexcept {
+        uint32_t level = handle->slot_ / num_slots;
+        uint32_t slot = handle->slot_ % num_slots;
+        auto &list = slots_[level][slot];
+        if (!list.remove(handle)) {
+            return false;
+        }
+        if (list.empty()) {
+            occupied_[level] &= ~(uint64_t(1) << slot);
+        }
+        size_--;
+        return true;
+    }
+
+    /**
+     * @brief Get the next time the wheel needs to advance to, either to expire
+     * timers or to move them to a lower level.
+     */
+    std::optional<uint64_t> next_expiration() const noexcept {
+        uint32_t level = first_level_();
+        if (level == num_levels) {
+            return std::nullopt;
+        }
+        return next_expiration_(level);
+    }
+
+    /**
+     * @brief Advance the wheel to now, calling func on each expired timer in
+     * order of deadlines.
+     */
+    template <typename Func> void advance(uint64_t now, Func &&func) noexcept {
+        uint32_t level;
+        while ((level = first_level_()) != num_levels) {
+            uint64_t expiration = next_expiration_(level);
+            if (expiration > now) {
+                break;
+            }
+            elapsed_ = expiration;
+            uint32_t slot = slot_of_(expiration, level);
+            auto list = std::move(slots_[level][slot]);
+            occupied_[level] &= ~(uint64_t(1) << slot);
+            while (auto *handle = list.pop_front()) {
+                if (handle->deadline_ <= elapsed_) {
+                    size_--;
+                    func(handle);
+                } else {
+                    insert_(handle);
+                }
+            }
+        }
+        elapsed_ = std::max(elapsed_, now);
+    }
+
+private:
+    static constexpr uint32_t slot_bits = 6;
+    static constexpr uint32_t num_slots = 1 << slot_bits;
+    static constexpr uint32_t num_levels = 6;
+    static constexpr uint64_t max_ticks = uint64_t(1)
+                                          << (slot_bits * num_levels);
+
+    using HandleList =
+        IntrusiveDoubleList<TimerHandle, &TimerHandle::link_entry_>;
+
+    static uint64_t slot_range_(uint32_t level) noexcept {
+        return uint64_t(1) << (slot_bits * level);
+    }
+
+    static uint32_t slot_of_(uint64_t deadline, uint32_t level) noexcept {
+        return static_cast<uint32_t>(deadline >> (slot_bits * level)) %
+               num_slots;
+    }
+
+    // The level is given by the highest bit in which the deadline differs
+    // from the current time. Deadlines beyond max_ticks go to the top level,
+    // and are moved again once their slot is reached.
+    uint32_t level_of_(uint64_t deadline) const noexcept {
+        uint64_t significant = (elapsed_ ^ deadline) | (num_slots - 1);
+        significant = std::min(significant, max_ticks - 1);
+        return static_cast<uint32_t>(63 - std::countl_zero(significant)) /
+               slot_bits;
+    }
+
+    // Timers in lower levels always expire before those in higher levels
+    uint32_t first_level_() const noexcept {
+        uint32_t level = 0;
+        while (level < num_levels && occupied_[level] == 0) {
+            level++;
+        }
+        return level;
+    }
+
+    void insert_(TimerHandle *handle) noexcept {
+        assert(handle->deadline_ > elapsed_);
+        uint32_t level = level_of_(handle->deadline_);
+        uint32_t slot = slot_of_(handle->deadline_, level);
+        handle->slot_ = level * num_slots + slot;
+        slots_[level][slot].push_back(handle);
+        occupied_[level] |= uint64_t(1) << slot;
+    }
+
+    uint64_t next_expiration_(uint32_t level) const noexcept {
+        uint64_t slot_range = slot_range_(level);
+        uint64_t level_range = slot_range * num_slots;
+        // Search occupied slots starting from the current one
+        uint32_t pos = slot_of_(elapsed_, level);
+        uint64_t rotated = std::rotr(occupied_[level], static_cast<int>(pos));
+        uint32_t slot = (pos + std::countr_zero(rotated)) % num_slots;
+        uint64_t deadline = (elapsed_ & ~(level_range - 1)) + slot * slot_range;
+        if (deadline <= elapsed_) {
+            // Only far deadlines at the top level wrap around
+            assert(level == num_levels - 1);
+            deadline += level_range;
+        }
+        return deadline;
+    }
+
+private:
+    HandleList slots_[num_levels][num_slots];
+    uint64_t occupied_[num_levels] = {};
+    uint64_t elapsed_ = 0;
+    size_t size_ = 0;
+};
+
+} // namespace detail
+
+} // namespace condy
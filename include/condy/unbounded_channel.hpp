@@ -0,0 +1,398 @@
+/**
+ * @file unbounded_channel.hpp
+ * @brief Thread-safe unbounded channel type for burst absorption.
+ * @details This file defines a thread-safe unbounded channel type, whose
+ * buffer grows and shrinks with the number of items in it.
+ */
+
+#pragma once
+
+#include "condy/context.hpp"
+#include "condy/intrusive.hpp"
+#include "condy/invoker.hpp"
+#include "condy/runtime.hpp"
+#include "condy/type_traits.hpp"
+#include "condy/utils.hpp"
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <type_traits>
+
+namespace condy {
+
+/**
+ * @brief Thread-safe unbounded channel for communication and synchronization.
+ * @tparam T Type of the items transmitted through the channel.
+ * @tparam SegmentSize Number of items in each buffer segment.
+ * @details Items are buffered in a linked list of fixed-size segments, so
+ * pushing never waits and only allocates once per segment. Drained segments
+ * are kept in a small free list for reuse, and freed once the free list is
+ * full, so memory drops back after a burst.
+ */
+template <typename T, size_t SegmentSize = 32> class UnboundedChannel {
+    static_assert(SegmentSize > 0, "SegmentSize must be greater than zero");
+
+public:
+    UnboundedChannel() = default;
+    ~UnboundedChannel() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        push_close_inner_();
+        destruct_all_();
+    }
+
+    UnboundedChannel(const UnboundedChannel &) = delete;
+    UnboundedChannel &operator=(const UnboundedChannel &) = delete;
+    UnboundedChannel(UnboundedChannel &&) = delete;
+    UnboundedChannel &operator=(UnboundedChannel &&) = delete;
+
+public:
+    /**
+     * @brief Try to push an item into the channel.
+     * @param item The item to be pushed into the channel.
+     * @return int32_t 0 if the item was successfully pushed; -EPIPE if the
+     * channel is closed; -ENOMEM if a new segment cannot be allocated.
+     */
+    template <typename U>
+        requires std::is_same_v<std::decay_t<U>, T>
+    int32_t try_push(U &&item) noexcept {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (closed_) {
+            return -EPIPE;
+        }
+        if (try_push_inner_(std::forward<U>(item))) {
+            return 0;
+        }
+        return -ENOMEM;
+    }
+
+    /**
+     * @brief Try to pop an item from the channel.
+     * @return std::pair<int32_t, T> 0 and the popped item if successful;
+     * -EPIPE if the channel is closed and no more items can be popped;
+     * -EAGAIN if the channel is empty.
+     */
+    std::pair<int32_t, T> try_pop() noexcept {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto item = try_pop_inner_();
+        if (item.has_value()) {
+            return {0, std::move(item.value())};
+        } else if (closed_) {
+            return {-EPIPE, T()};
+        } else {
+            return {-EAGAIN, T()};
+        }
+    }
+
+    void force_push(T item) noexcept {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (closed_) [[unlikely]] {
+            panic_on("Push to closed channel");
+        }
+        if (!try_push_inner_(std::move(item))) [[unlikely]] {
+            panic_on("Allocation failed for channel segment");
+        }
+    }
+
+    class [[nodiscard]] PopSender;
+    /**
+     * @brief Pop an item from the channel, awaiting if necessary.
+     * @return std::pair<int32_t, T> 0 and the popped item if successful; -EPIPE
+     * if the channel is closed and no more items can be popped; -ECANCELED if
+     * the operation was cancelled while waiting.
+     */
+    PopSender pop() noexcept { return {*this}; }
+
+    /**
+     * @brief Get the current size of the channel.
+     * @warning This function may not be accurate in multithreaded scenarios.
+     */
+    size_t size() const noexcept {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return size_;
+    }
+
+    /**
+     * @brief Check if the channel is empty.
+     * @warning This function may not be accurate in multithreaded scenarios.
+     */
+    bool empty() const noexcept {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return size_ == 0;
+    }
+
+    /**
+     * @brief Check if the channel is closed.
+     * @warning This function may not be accurate in multithreaded scenarios.
+     */
+    bool is_closed() const noexcept {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return closed_;
+    }
+
+    /**
+     * @brief Close the channel.
+     * @details This function closes the channel. After the channel is closed,
+     * no more items can be pushed into the channel. All pending pop operations
+     * will fail with -EPIPE, and future ones will fail with -EPIPE once there
+     * are no more items to pop.
+     * @note This function is idempotent.
+     */
+    void push_close() noexcept {
+        std::lock_guard<std::mutex> lock(mutex_);
+        push_close_inner_();
+    }
+
+private:
+    class PopFinishHandleBase;
+    template <typename Receiver> class PopFinishHandle;
+
+    std::pair<int32_t, T>
+    request_pop_(PopFinishHandleBase *finish_handle) noexcept {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto result = try_pop_inner_();
+        if (result.has_value()) {
+            return {0, std::move(result.value())};
+        }
+        if (closed_) {
+            return {-EPIPE, T()};
+        }
+        pop_awaiters_.push_back(finish_handle);
+        detail::Context::current().runtime()->pend_work();
+        return {-EAGAIN, T()};
+    }
+
+    bool cancel_pop_(PopFinishHandleBase *finish_handle) noexcept {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return pop_awaiters_.remove(finish_handle);
+    }
+
+private:
+    struct Segment {
+        Segment *next = nullptr;
+        RawStorage<T> items[SegmentSize];
+    };
+
+    static constexpr size_t max_spare_segments = 4;
+
+    template <typename U>
+        requires std::is_same_v<std::decay_t<U>, T>
+    bool try_push_inner_(U &&item) noexcept {
+        if (!pop_awaiters_.empty()) {
+            assert(size_ == 0);
+            auto *pop_handle = pop_awaiters_.pop_front();
+            pop_handle->set_result({0, std::forward<U>(item)});
+            pop_handle->schedule();
+            return true;
+        }
+        if (tail_ == nullptr || tail_index_ == SegmentSize) {
+            Segment *segment = acquire_segment_();
+            if (segment == nullptr) {
+                return false;
+            }
+            if (tail_ == nullptr) {
+                head_ = segment;
+            } else {
+                tail_->next = segment;
+            }
+            tail_ = segment;
+            tail_index_ = 0;
+        }
+        tail_->items[tail_index_++].construct(std::forward<U>(item));
+        size_++;
+        return true;
+    }
+
+    std::optional<T> try_pop_inner_() noexcept {
+        if (size_ == 0) {
+            return std::nullopt;
+        }
+        auto &storage = head_->items[head_index_++];
+        std::optional<T> item(std::move(storage.get()));
+        storage.destroy();
+        size_--;
+        if (size_ == 0) {
+            // Reuse the current segment from its start
+            assert(head_ == tail_);
+            head_index_ = tail_index_ = 0;
+        } else if (head_index_ == SegmentSize) {
+            Segment *next = head_->next;
+            release_segment_(head_);
+            head_ = next;
+            head_index_ = 0;
+        }
+        return item;
+    }
+
+    Segment *acquire_segment_() noexcept {
+        Segment *segment = free_segments_;
+        if (segment != nullptr) {
+            free_segments_ = segment->next;
+            num_free_segments_--;
+            segment->next = nullptr;
+            return segment;
+        }
+        return new (std::nothrow) Segment;
+    }
+
+    void release_segment_(Segment *segment) noexcept {
+        if (num_free_segments_ == max_spare_segments) {
+            delete segment;
+            return;
+        }
+        segment->next = free_segments_;
+        free_segments_ = segment;
+        num_free_segments_++;
+    }
+
+    void push_close_inner_() noexcept {
+        if (closed_) {
+            return;
+        }
+        closed_ = true;
+        // Cancel all pending pop awaiters
+        PopFinishHandleBase *pop_handle = nullptr;
+        while ((pop_handle = pop_awaiters_.pop_front()) != nullptr) {
+            assert(size_ == 0);
+            pop_handle->set_result({-EPIPE, T()});
+            pop_handle->schedule();
+        }
+    }
+
+    void destruct_all_() noexcept {
+        while (try_pop_inner_().has_value()) {
+        }
+        delete head_;
+        while (Segment *segment = free_segments_) {
+            free_segments_ = segment->next;
+            delete segment;
+        }
+    }
+
+private:
+    template <typename Handle>
+    using HandleList = IntrusiveDoubleList<Handle, &Handle::link_entry_>;
+
+    mutable std::mutex mutex_;
+    HandleList<PopFinishHandleBase> pop_awaiters_;
+    Segment *head_ = nullptr;
+    Segment *tail_ = nullptr;
+    size_t head_index_ = 0;
+    size_t tail_index_ = 0;
+    size_t size_ = 0;
+    Segment *free_segments_ = nullptr;
+    size_t num_free_segments_ = 0;
+    bool closed_ = false;
+};
+
+template <typename T, size_t SegmentSize>
+class UnboundedChannel<T, SegmentSize>::PopFinishHandleBase
+    : public WorkInvoker {
+public:
+    void schedule() noexcept {
+        assert(runtime_ != nullptr);
+        runtime_->schedule(this);
+    }
+
+    void set_result(std::pair<int32_t, T> result) noexcept {
+        result_ = std::move(result);
+    }
+
+public:
+    DoubleLinkEntry link_entry_;
+
+protected:
+    Runtime *runtime_ = nullptr;
+    // Internal error if not set
+    std::pair<int32_t, T> result_ = {-ENOTRECOVERABLE, T()};
+};
+
+template <typename T, size_t SegmentSize>
+template <typename Receiver>
+class UnboundedChannel<T, SegmentSize>::PopFinishHandle
+    : public InvokerAdapter<PopFinishHandle<Receiver>, PopFinishHandleBase> {
+public:
+    PopFinishHandle(UnboundedChannel &channel, Receiver receiver)
+        : channel_(channel), receiver_(std::move(receiver)) {}
+
+    void start(Runtime *runtime) noexcept {
+        this->runtime_ = runtime;
+        this->set_priority(detail::Context::current().priority());
+        auto item = channel_.request_pop_(this);
+        auto r = item.first;
+        if (r != -EAGAIN) {
+            std::move(receiver_)(std::move(item));
+            return;
+        }
+
+        auto stop_token = receiver_.get_stop_token();
+        if (stop_token.stop_possible()) {
+            stop_callback_.emplace(std::move(stop_token), Cancellation{this});
+        }
+    }
+
+    void invoke() noexcept {
+        stop_callback_.reset();
+        assert(this->runtime_ != nullptr);
+        this->runtime_->resume_work();
+        std::move(receiver_)(std::move(this->result_));
+    }
+
+private:
+    void cancel_() noexcept {
+        if (channel_.cancel_pop_(this)) {
+            // Successfully canceled
+            assert(this->result_.first == -ENOTRECOVERABLE);
+            this->result_.first = -ECANCELED;
+            assert(this->runtime_ != nullptr);
+            this->runtime_->schedule(this);
+        }
+    }
+
+    struct Cancellation {
+        PopFinishHandle *self;
+        void operator()() noexcept { self->cancel_(); }
+    };
+
+    using StopCallbackType =
+        stop_callback_t<stop_token_t<Receiver>, Cancellation>;
+
+private:
+    UnboundedChannel &channel_;
+    Receiver receiver_;
+    std::optional<StopCallbackType> stop_callback_;
+};
+
+template <typename T, size_t SegmentSize>
+class UnboundedChannel<T, SegmentSize>::PopSender {
+public:
+    using ReturnType = std::pair<int32_t, T>;
+
+    PopSender(UnboundedChannel &channel) : channel_(channel) {}
+
+    template <typename Receiver> auto connect(Receiver receiver) noexcept {
+        return OperationState<Receiver>(channel_, std::move(receiver));
+    }
+
+private:
+    template <typename Receiver>
+    class OperationState
+        : public UnboundedChannel<T, SegmentSize>::template PopFinishHandle<
+              Receiver> {
+    public:
+        using Base = typename UnboundedChannel<
+            T, SegmentSize>::template PopFinishHandle<Receiver>;
+        using Base::Base;
+
+        void start(unsigned int /*flags*/) noexcept {
+            auto *runtime = detail::Context::current().runtime();
+            Base::start(runtime);
+        }
+    };
+
+    UnboundedChannel &channel_;
+};
+
+} // namespace condy
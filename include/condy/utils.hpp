@@ -62,6 +62,20 @@ inline void tsan_release([[maybe_unused]] void *addr) noexcept {
 
 namespace condy {
 
+// Hint the CPU that we are in a spin-wait loop.
+inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+// Used to keep data written by different threads on separate cache lines.
+// std::hardware_destructive_interference_size is not used here since its value
+// may vary between compiler flags, which makes it ABI-unstable.
+inline constexpr size_t cache_line_size = 64;
+
 template <typename Func> class [[nodiscard]] Defer {
 public:
     Defer(Func func) : func_(std::move(func)) {}
@@ -0,0 +1,159 @@
+/**
+ * @file wait_group.hpp
+ * @brief Wait group and latch for coroutines.
+ * @details This file defines condy::WaitGroup and condy::Latch, which let a
+ * coroutine wait for a group of tasks or events to complete. They can be used
+ * across different Runtimes.
+ */
+
+#pragma once
+
+#include "condy/parking_lot.hpp"
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+namespace condy {
+
+namespace detail {
+
+inline void count_down(std::atomic_size_t &count, size_t n) noexcept {
+    auto prev = count.fetch_sub(n, std::memory_order_acq_rel);
+    assert(prev >= n);
+    if (prev == n) {
+        ParkingLot::instance().unpark(&count, SIZE_MAX, 0);
+    }
+}
+
+// Count down by n on arrival, then park until the count reaches zero
+struct CountDownCondition {
+    std::atomic_size_t *count;
+    size_t n;
+
+    const void *key() const noexcept { return count; }
+
+    void arrive() noexcept {
+        if (n != 0) {
+            count_down(*count, n);
+        }
+    }
+
+    bool should_park() noexcept {
+        return count->load(std::memory_order_acquire) != 0;
+    }
+};
+
+} // namespace detail
+
+/**
+ * @brief Wait for a group of tasks to complete.
+ * @details Each task is counted with add() before it starts, and calls done()
+ * when it completes. done() is a single atomic decrement, and only the last
+ * one wakes up the awaiting coroutines. The counter may be reused once it
+ * reaches zero.
+ */
+class WaitGroup {
+public:
+    WaitGroup() = default;
+
+    WaitGroup(const WaitGroup &) = delete;
+    WaitGroup &operator=(const WaitGroup &) = delete;
+    WaitGroup(WaitGroup &&) = delete;
+    WaitGroup &operator=(WaitGroup &&) = delete;
+
+public:
+    /**
+     * @brief Add tasks to the group.
+     * @param n Number of tasks to add.
+     */
+    void add(size_t n = 1) noexcept {
+        count_.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Mark a task of the group as completed.
+     * @note This function is thread-safe and can be called from any thread.
+     */
+    void done() noexcept { detail::count_down(count_, 1); }
+
+    /**
+     * @brief Wait until all tasks of the group are completed.
+     * @return int32_t 0 if all tasks are completed; -ECANCELED if the wait
+     * operation is canceled while waiting.
+     */
+    detail::ParkSender<detail::CountDownCondition> wait() noexcept {
+        return detail::CountDownCondition{&count_, 0};
+    }
+
+    /**
+     * @brief Get the number of uncompleted tasks.
+     * @warning This function may not be accurate in multithreaded scenarios.
+     */
+    size_t count() const noexcept {
+        return count_.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic_size_t count_ = 0;
+};
+
+/**
+ * @brief Single-use countdown latch.
+ * @details The latch is constructed with an expected count, and opens once it
+ * is counted down to zero. Coroutines awaiting wait() are woken up together
+ * when the latch opens. Unlike condy::WaitGroup, the latch can not be reset.
+ */
+class Latch {
+public:
+    /**
+     * @brief Construct a new Latch object
+     * @param expected Number of count downs to open the latch.
+     */
+    Latch(size_t expected) : count_(expected) {}
+
+    Latch(const Latch &) = delete;
+    Latch &operator=(const Latch &) = delete;
+    Latch(Latch &&) = delete;
+    Latch &operator=(Latch &&) = delete;
+
+public:
+    /**
+     * @brief Count down the latch.
+     * @param n Number to count down by.
+     * @note This function is thread-safe and can be called from any thread.
+     */
+    void count_down(size_t n = 1) noexcept { detail::count_down(count_, n); }
+
+    /**
+     * @brief Check if the latch is open without awaiting.
+     */
+    bool try_wait() const noexcept {
+        return count_.load(std::memory_order_acquire) == 0;
+    }
+
+    /**
+     * @brief Wait until the latch is open.
+     * @return int32_t 0 if the latch is open; -ECANCELED if the wait operation
+     * is canceled while waiting.
+     */
+    detail::ParkSender<detail::CountDownCondition> wait() noexcept {
+        return detail::CountDownCondition{&count_, 0};
+    }
+
+    /**
+     * @brief Count down the latch and wait until it is open.
+     * @param n Number to count down by.
+     * @return int32_t 0 if the latch is open; -ECANCELED if the wait operation
+     * is canceled while waiting. The count down is not undone on cancellation.
+     */
+    detail::ParkSender<detail::CountDownCondition>
+    arrive_and_wait(size_t n = 1) noexcept {
+        return detail::CountDownCondition{&count_, n};
+    }
+
+private:
+    std::atomic_size_t count_;
+};
+
+} // namespace condy
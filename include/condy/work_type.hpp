@@ -17,6 +17,7 @@ enum class WorkType : uint8_t {
     Ignore,
     Schedule,
     Cancel,
+    Timer,
 
     // Add new work types above this line
     WorkTypeMax,
@@ -2,11 +2,13 @@
 #include <cerrno>
 #include <condy/awaiter_operations.hpp>
 #include <condy/awaiters.hpp>
+#include <chrono>
 #include <condy/coro.hpp>
 #include <cstddef>
 #include <cstring>
 #include <doctest/doctest.h>
 #include <stdexcept>
+#include <unistd.h>
 
 using namespace condy::operators;
 
@@ -328,4 +330,75 @@ TEST_CASE("test awaiter_operations - test parallel all") {
 
     condy::sync_wait(std::move(coro));
     REQUIRE(unfinished == 0);
-}
\ No newline at end of file
+}
+
+TEST_CASE("test awaiter_operations - test with_timeout") {
+    using namespace std::chrono_literals;
+    int pipe_fds[2];
+    REQUIRE(pipe(pipe_fds) == 0);
+
+    size_t unfinished = 1;
+    auto func = [&]() -> condy::Coro<void> {
+        char buffer[16];
+        // Single operation, cancelled by a linked timeout
+        auto start = std::chrono::steady_clock::now();
+        int r = co_await condy::with_timeout(
+            condy::detail::make_op_awaiter(io_uring_prep_read, pipe_fds[0],
+                                           buffer, sizeof(buffer), 0),
+            10ms);
+        REQUIRE(r == -ECANCELED);
+        REQUIRE(std::chrono::steady_clock::now() - start >= 10ms);
+
+        // Completes before the timeout
+        r = co_await condy::with_timeout(
+            condy::detail::make_op_awaiter(io_uring_prep_nop), 10s);
+        REQUIRE(r == 0);
+
+        // Linked to the next operation
+        auto [r1, r2] = co_await (
+            condy::with_timeout(
+                condy::detail::make_op_awaiter(io_uring_prep_nop), 10s) >>
+            condy::detail::make_op_awaiter(io_uring_prep_nop));
+        REQUIRE(r1 == 0);
+        REQUIRE(r2 == 0);
+        --unfinished;
+    };
+
+    condy::sync_wait(func());
+    REQUIRE(unfinished == 0);
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+}
+
+TEST_CASE("test awaiter_operations - test with_deadline composed") {
+    using namespace std::chrono_literals;
+    int pipe_fds[2];
+    REQUIRE(pipe(pipe_fds) == 0);
+
+    size_t unfinished = 1;
+    auto func = [&]() -> condy::Coro<void> {
+        char buffer[16];
+        auto read = [&]() {
+            return condy::detail::make_op_awaiter(
+                io_uring_prep_read, pipe_fds[0], buffer, sizeof(buffer), 0);
+        };
+        // Composed operations fall back to the timer of the runtime
+        auto [r1, r2] = co_await condy::with_deadline(
+            read() && read(), std::chrono::steady_clock::now() + 10ms);
+        REQUIRE(r1 == -ECANCELED);
+        REQUIRE(r2 == -ECANCELED);
+
+        auto [r3, r4] = co_await condy::with_deadline(
+            condy::detail::make_op_awaiter(io_uring_prep_nop) &&
+                condy::detail::make_op_awaiter(io_uring_prep_nop),
+            std::chrono::steady_clock::now() + 10s);
+        REQUIRE(r3 == 0);
+        REQUIRE(r4 == 0);
+        --unfinished;
+    };
+
+    condy::sync_wait(func());
+    REQUIRE(unfinished == 0);
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+}
@@ -0,0 +1,135 @@
+#include "condy/async_operations.hpp"
+#include "condy/awaiter_operations.hpp"
+#include "condy/barrier.hpp"
+#include "condy/coro.hpp"
+#include "condy/runtime.hpp"
+#include "condy/runtime_options.hpp"
+#include "condy/sync_wait.hpp"
+#include "condy/task.hpp"
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <doctest/doctest.h>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+auto options = condy::RuntimeOptions().sq_size(8).cq_size(16);
+
+} // namespace
+
+TEST_CASE("test barrier - phases") {
+    condy::Barrier barrier(3);
+
+    const size_t num_phases = 10;
+    size_t arrived[num_phases] = {};
+    auto worker = [&]() -> condy::Coro<void> {
+        for (size_t i = 0; i < num_phases; ++i) {
+            arrived[i]++;
+            REQUIRE(co_await barrier.arrive_and_wait() == 0);
+            // Everyone arrived at this phase
+            REQUIRE(arrived[i] == 3);
+        }
+    };
+
+    auto func = [&]() -> condy::Coro<void> {
+        auto t1 = condy::co_spawn(worker());
+        auto t2 = condy::co_spawn(worker());
+        auto t3 = condy::co_spawn(worker());
+        co_await std::move(t1);
+        co_await std::move(t2);
+        co_await std::move(t3);
+        REQUIRE(barrier.phase() == num_phases);
+    };
+
+    condy::Runtime runtime(options);
+    condy::sync_wait(runtime, func());
+}
+
+TEST_CASE("test barrier - arrive and drop") {
+    condy::Barrier barrier(2);
+
+    auto waiter = [&]() -> condy::Coro<void> {
+        REQUIRE(co_await barrier.arrive_and_wait() == 0);
+    };
+
+    auto func = [&]() -> condy::Coro<void> {
+        auto t = condy::co_spawn(waiter());
+        co_await condy::async_nop();
+        REQUIRE(barrier.phase() == 0);
+
+        barrier.arrive_and_drop();
+        co_await std::move(t);
+        REQUIRE(barrier.phase() == 1);
+
+        // Only one participant left
+        REQUIRE(co_await barrier.arrive_and_wait() == 0);
+        REQUIRE(barrier.phase() == 2);
+    };
+
+    condy::Runtime runtime(options);
+    condy::sync_wait(runtime, func());
+}
+
+TEST_CASE("test barrier - cancel wait") {
+    using condy::operators::operator||;
+
+    condy::Barrier barrier(2);
+
+    auto func = [&]() -> condy::Coro<void> {
+        __kernel_timespec ts{
+            .tv_sec = 0,
+            .tv_nsec = 1000000,
+        };
+        auto r = co_await (barrier.arrive_and_wait() ||
+                           condy::async_timeout(&ts, 0, 0));
+        REQUIRE(r.index() == 1);
+
+        // The cancelled arrival still counts
+        REQUIRE(co_await barrier.arrive_and_wait() == 0);
+        REQUIRE(barrier.phase() == 1);
+    };
+
+    condy::Runtime runtime(options);
+    condy::sync_wait(runtime, func());
+}
+
+TEST_CASE("test barrier - across runtimes") {
+    const size_t num_runtimes = 4;
+    const size_t num_phases = 200;
+
+    condy::Barrier barrier(num_runtimes);
+
+    std::atomic_size_t arrived[num_phases] = {};
+    auto worker = [&]() -> condy::Coro<void> {
+        for (size_t i = 0; i < num_phases; ++i) {
+            arrived[i].fetch_add(1, std::memory_order_relaxed);
+            REQUIRE(co_await barrier.arrive_and_wait() == 0);
+            REQUIRE(arrived[i].load(std::memory_order_relaxed) ==
+                    num_runtimes);
+        }
+    };
+
+    std::vector<std::unique_ptr<condy::Runtime>> runtimes;
+    std::vector<std::thread> threads;
+    std::vector<condy::Task<void>> tasks;
+    for (size_t i = 0; i < num_runtimes; ++i) {
+        runtimes.push_back(std::make_unique<condy::Runtime>(options));
+        tasks.push_back(condy::co_spawn(*runtimes.back(), worker()));
+    }
+    for (auto &runtime : runtimes) {
+        threads.emplace_back([&runtime]() {
+            runtime->allow_exit();
+            runtime->run();
+        });
+    }
+    for (auto &task : tasks) {
+        task.wait();
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    REQUIRE(barrier.phase() == num_phases);
+}
@@ -0,0 +1,109 @@
+#include "condy/block_cache.hpp"
+#include "condy/context.hpp"
+#include "condy/runtime.hpp"
+#include "condy/runtime_options.hpp"
+#include "condy/sync_wait.hpp"
+#include "condy/task.hpp"
+#include "condy/utils.hpp"
+#include <cstdint>
+#include <cstring>
+#include <doctest/doctest.h>
+#include <thread>
+
+using condy::detail::BlockCache;
+using condy::detail::Context;
+
+TEST_CASE("test block_cache - without cache") {
+    void *ptr = BlockCache::allocate(100);
+    REQUIRE(ptr != nullptr);
+    REQUIRE(reinterpret_cast<uintptr_t>(ptr) %
+                __STDCPP_DEFAULT_NEW_ALIGNMENT__ ==
+            0);
+    std::memset(ptr, 0xff, 100);
+    BlockCache::deallocate(ptr);
+    BlockCache::deallocate(nullptr);
+}
+
+TEST_CASE("test block_cache - recycle blocks") {
+    BlockCache cache;
+    Context::current().init(nullptr, nullptr, &cache);
+    auto d = condy::defer([]() { Context::current().reset(); });
+
+    void *ptr1 = BlockCache::allocate(100);
+    BlockCache::deallocate(ptr1);
+
+    // Same size class
+    void *ptr2 = BlockCache::allocate(80);
+    REQUIRE(ptr2 == ptr1);
+
+    // Different size class
+    void *ptr3 = BlockCache::allocate(1000);
+    REQUIRE(ptr3 != ptr1);
+
+    BlockCache::deallocate(ptr2);
+    BlockCache::deallocate(ptr3);
+}
+
+TEST_CASE("test block_cache - large blocks") {
+    BlockCache cache;
+    Context::current().init(nullptr, nullptr, &cache);
+    auto d = condy::defer([]() { Context::current().reset(); });
+
+    void *ptr = BlockCache::allocate(1024 * 1024);
+    std::memset(ptr, 0xff, 1024 * 1024);
+    BlockCache::deallocate(ptr);
+}
+
+TEST_CASE("test block_cache - free in another thread") {
+    void *ptr = nullptr;
+    {
+        BlockCache cache;
+        Context::current().init(nullptr, nullptr, &cache);
+        ptr = BlockCache::allocate(100);
+        Context::current().reset();
+    }
+    // Cache of the allocating thread is gone, free with the global allocator
+    BlockCache::deallocate(ptr);
+
+    BlockCache cache;
+    Context::current().init(nullptr, nullptr, &cache);
+    auto d = condy::defer([]() { Context::current().reset(); });
+    ptr = BlockCache::allocate(100);
+    std::thread([ptr]() { BlockCache::deallocate(ptr); }).join();
+}
+
+TEST_CASE("test block_cache - recycle coroutine frames") {
+    auto options = condy::RuntimeOptions().sq_size(8).cq_size(16);
+
+    auto func = []() -> condy::Coro<void> {
+        REQUIRE(Context::current().block_cache() != nullptr);
+        auto inner = []() -> condy::Coro<void> { co_return; };
+        void *first = nullptr;
+        for (int i = 0; i < 10; i++) {
+            auto handle = inner().release();
+            if (first == nullptr) {
+                first = handle.address();
+            } else {
+                REQUIRE(handle.address() == first);
+            }
+            handle.destroy();
+        }
+        co_return;
+    };
+
+    condy::Runtime runtime(options);
+    condy::sync_wait(runtime, func());
+}
+
+TEST_CASE("test block_cache - disable frame cache") {
+    auto options =
+        condy::RuntimeOptions().sq_size(8).cq_size(16).disable_frame_cache();
+
+    auto func = []() -> condy::Coro<void> {
+        REQUIRE(Context::current().block_cache() == nullptr);
+        co_return;
+    };
+
+    condy::Runtime runtime(options);
+    condy::sync_wait(runtime, func());
+}
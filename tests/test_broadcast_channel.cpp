@@ -0,0 +1,190 @@
+#include "condy/async_operations.hpp"
+#include "condy/awaiter_operations.hpp"
+#include "condy/broadcast_channel.hpp"
+#include "condy/coro.hpp"
+#include "condy/runtime.hpp"
+#include "condy/runtime_options.hpp"
+#include "condy/sync_wait.hpp"
+#include "condy/task.hpp"
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <doctest/doctest.h>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+auto options = condy::RuntimeOptions().sq_size(8).cq_size(16);
+
+} // namespace
+
+TEST_CASE("test broadcast_channel - try recv") {
+    condy::BroadcastChannel<int> channel(3);
+    REQUIRE(channel.capacity() == 4);
+
+    auto sub1 = channel.subscribe();
+    REQUIRE(channel.publish(1) == 0);
+    auto sub2 = channel.subscribe();
+    REQUIRE(channel.publish(2) == 0);
+
+    auto [r1, item1] = sub1.try_recv();
+    REQUIRE(r1 == 0);
+    REQUIRE(*item1 == 1);
+    auto [r2, item2] = sub1.try_recv();
+    REQUIRE(r2 == 0);
+    REQUIRE(*item2 == 2);
+    REQUIRE(sub1.try_recv().first == -EAGAIN);
+
+    // Subscribers share the same item
+    auto [r3, item3] = sub2.try_recv();
+    REQUIRE(r3 == 0);
+    REQUIRE(item3 == item2);
+
+    channel.close();
+    REQUIRE(channel.is_closed());
+    REQUIRE(channel.publish(3) == -EPIPE);
+    REQUIRE(sub1.try_recv().first == -EPIPE);
+    REQUIRE(sub2.try_recv().first == -EPIPE);
+}
+
+TEST_CASE("test broadcast_channel - lagged subscriber") {
+    condy::BroadcastChannel<int> channel(2);
+    auto sub = channel.subscribe();
+
+    for (int i = 1; i <= 5; ++i) {
+        REQUIRE(channel.publish(i) == 0);
+    }
+
+    REQUIRE(sub.try_recv().first == -EOVERFLOW);
+    auto [r1, item1] = sub.try_recv();
+    REQUIRE(r1 == 0);
+    REQUIRE(*item1 == 4);
+    auto [r2, item2] = sub.try_recv();
+    REQUIRE(r2 == 0);
+    REQUIRE(*item2 == 5);
+    REQUIRE(sub.try_recv().first == -EAGAIN);
+}
+
+TEST_CASE("test broadcast_channel - recv with coroutines") {
+    condy::BroadcastChannel<int> channel(4);
+
+    const int max_items = 100;
+    const size_t num_subscribers = 3;
+
+    size_t finished = 0;
+    auto subscriber = [&](condy::BroadcastChannel<int>::Subscriber sub)
+        -> condy::Coro<void> {
+        int expected = 1;
+        while (true) {
+            auto [r, item] = co_await sub.recv();
+            if (r == -EPIPE) {
+                break;
+            }
+            REQUIRE(r == 0);
+            REQUIRE(*item == expected++);
+        }
+        REQUIRE(expected == max_items + 1);
+        finished++;
+    };
+
+    auto publisher = [&]() -> condy::Coro<void> {
+        for (int i = 1; i <= max_items; ++i) {
+            REQUIRE(channel.publish(i) == 0);
+            // Let subscribers catch up
+            co_await condy::async_nop();
+        }
+        channel.close();
+    };
+
+    auto func = [&]() -> condy::Coro<void> {
+        std::vector<condy::Task<void>> tasks;
+        for (size_t i = 0; i < num_subscribers; ++i) {
+            tasks.push_back(condy::co_spawn(subscriber(channel.subscribe())));
+        }
+        tasks.push_back(condy::co_spawn(publisher()));
+        for (auto &task : tasks) {
+            co_await std::move(task);
+        }
+    };
+
+    condy::Runtime runtime(options);
+    condy::sync_wait(runtime, func());
+    REQUIRE(finished == num_subscribers);
+}
+
+TEST_CASE("test broadcast_channel - cancel recv") {
+    using condy::operators::operator||;
+
+    condy::BroadcastChannel<int> channel(2);
+    auto sub = channel.subscribe();
+
+    auto func = [&]() -> condy::Coro<void> {
+        __kernel_timespec ts{
+            .tv_sec = 0,
+            .tv_nsec = 1000000,
+        };
+        auto r = co_await (sub.recv() || condy::async_timeout(&ts, 0, 0));
+        REQUIRE(r.index() == 1);
+
+        REQUIRE(channel.publish(42) == 0);
+        auto [r2, item] = co_await sub.recv();
+        REQUIRE(r2 == 0);
+        REQUIRE(*item == 42);
+    };
+
+    condy::Runtime runtime(options);
+    condy::sync_wait(runtime, func());
+}
+
+TEST_CASE("test broadcast_channel - cross runtimes") {
+    condy::BroadcastChannel<int> channel(1024);
+
+    const int max_items = 1000;
+    const size_t num_runtimes = 3;
+
+    std::atomic_size_t finished = 0;
+    auto subscriber = [&](condy::BroadcastChannel<int>::Subscriber sub)
+        -> condy::Coro<void> {
+        int expected = 1;
+        while (true) {
+            auto [r, item] = co_await sub.recv();
+            if (r == -EPIPE) {
+                break;
+            }
+            REQUIRE(r == 0);
+            REQUIRE(*item == expected++);
+        }
+        REQUIRE(expected == max_items + 1);
+        finished++;
+    };
+
+    std::vector<std::unique_ptr<condy::Runtime>> runtimes;
+    std::vector<std::thread> threads;
+    std::vector<condy::Task<void>> tasks;
+    for (size_t i = 0; i < num_runtimes; ++i) {
+        runtimes.push_back(std::make_unique<condy::Runtime>(options));
+        tasks.push_back(
+            condy::co_spawn(*runtimes.back(), subscriber(channel.subscribe())));
+    }
+    for (auto &runtime : runtimes) {
+        threads.emplace_back([&runtime]() {
+            runtime->allow_exit();
+            runtime->run();
+        });
+    }
+
+    for (int i = 1; i <= max_items; ++i) {
+        REQUIRE(channel.publish(i) == 0);
+    }
+    channel.close();
+
+    for (auto &task : tasks) {
+        task.wait();
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    REQUIRE(finished == num_runtimes);
+}
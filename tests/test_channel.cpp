@@ -5,10 +5,15 @@
 #include "condy/runtime_options.hpp"
 #include "condy/sync_wait.hpp"
 #include "condy/task.hpp"
+#include <algorithm>
 #include <atomic>
 #include <cerrno>
 #include <cstddef>
 #include <doctest/doctest.h>
+#include <memory>
+#include <span>
+#include <thread>
+#include <vector>
 
 namespace {
 
@@ -58,6 +63,112 @@ TEST_CASE("test channel - try push conditonal move") {
     REQUIRE(item2 != nullptr); // item2 should not be moved
 }
 
+TEST_CASE("test channel - try push and pop many") {
+    condy::Channel<int> channel(4);
+
+    int items[] = {1, 2, 3, 4, 5, 6};
+    REQUIRE(channel.try_push_many(items) == 4);
+    REQUIRE(channel.size() == 4);
+    REQUIRE(channel.try_push_many(std::span(items).subspan(4)) == -EAGAIN);
+
+    int out[3] = {};
+    REQUIRE(channel.try_pop_many(out) == 3);
+    REQUIRE(out[0] == 1);
+    REQUIRE(out[1] == 2);
+    REQUIRE(out[2] == 3);
+
+    REQUIRE(channel.try_push_many(std::span(items).subspan(4)) == 2);
+    REQUIRE(channel.try_pop_many(out) == 3);
+    REQUIRE(out[0] == 4);
+    REQUIRE(out[1] == 5);
+    REQUIRE(out[2] == 6);
+    REQUIRE(channel.try_pop_many(out) == -EAGAIN);
+
+    channel.push_close();
+    REQUIRE(channel.try_push_many(items) == -EPIPE);
+    REQUIRE(channel.try_pop_many(out) == -EPIPE);
+}
+
+TEST_CASE("test channel - push and pop many with coroutines") {
+    condy::Runtime runtime(options);
+    condy::Channel<int> channel(4);
+
+    const int max_items = 100;
+
+    auto producer = [&]() -> condy::Coro<void> {
+        std::vector<int> items;
+        for (int i = 1; i <= max_items; ++i) {
+            items.push_back(i);
+        }
+        std::span<int> rest(items);
+        while (!rest.empty()) {
+            int r = co_await channel.push_many(rest);
+            REQUIRE(r > 0);
+            rest = rest.subspan(r);
+        }
+        channel.push_close();
+    };
+
+    auto consumer = [&]() -> condy::Coro<void> {
+        int expected = 1;
+        int out[3];
+        while (true) {
+            int r = co_await channel.pop_many(out);
+            if (r == -EPIPE) {
+                break;
+            }
+            REQUIRE(r > 0);
+            for (int i = 0; i < r; ++i) {
+                REQUIRE(out[i] == expected++);
+            }
+        }
+        REQUIRE(expected == max_items + 1);
+    };
+
+    auto t1 = condy::co_spawn(runtime, consumer());
+    auto t2 = condy::co_spawn(runtime, producer());
+
+    runtime.allow_exit();
+    runtime.run();
+
+    t1.wait();
+    t2.wait();
+}
+
+TEST_CASE("test channel - push and pop many with awaiters") {
+    condy::Runtime runtime(options);
+    condy::Channel<int> channel(0);
+
+    auto consumer = [&]() -> condy::Coro<void> {
+        int out[4];
+        // Woken by the first item, then takes the item of the awaiting push
+        int r = co_await channel.pop_many(out);
+        REQUIRE(r == 2);
+        REQUIRE(out[0] == 1);
+        REQUIRE(out[1] == 2);
+        r = co_await channel.pop_many(out);
+        REQUIRE(r == 1);
+        REQUIRE(out[0] == 3);
+    };
+
+    auto producer = [&]() -> condy::Coro<void> {
+        int items[] = {1, 2, 3};
+        int r = co_await channel.push_many(items);
+        REQUIRE(r == 1);
+        r = co_await channel.push_many(std::span(items).subspan(1));
+        REQUIRE(r == 2);
+    };
+
+    auto t1 = condy::co_spawn(runtime, consumer());
+    auto t2 = condy::co_spawn(runtime, producer());
+
+    runtime.allow_exit();
+    runtime.run();
+
+    t1.wait();
+    t2.wait();
+}
+
 TEST_CASE("test channel - push and pop with coroutines") {
     condy::Runtime runtime(options);
     condy::Channel<int> channel(2);
@@ -633,6 +744,150 @@ TEST_CASE("test channel - cross runtimes") {
     t2.join();
 }
 
+TEST_CASE("test channel - try push and pop across threads") {
+    condy::Channel<size_t> channel(1);
+
+    const size_t num_threads = 4;
+    const size_t num_items = 10000;
+
+    std::atomic_size_t sum = 0;
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&]() {
+            for (size_t i = 1; i <= num_items; ++i) {
+                while (channel.try_push(size_t(i)) != 0) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+        threads.emplace_back([&]() {
+            size_t popped = 0;
+            while (popped < num_items) {
+                auto [r, item] = channel.try_pop();
+                if (r == 0) {
+                    sum += item;
+                    popped++;
+                } else {
+                    REQUIRE(r == -EAGAIN);
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    REQUIRE(sum == num_threads * num_items * (num_items + 1) / 2);
+    REQUIRE(channel.empty());
+}
+
+TEST_CASE("test channel - try push and pop many across threads") {
+    condy::Channel<size_t> channel(8);
+
+    const size_t num_threads = 4;
+    const size_t num_items = 10000;
+
+    std::atomic_size_t sum = 0;
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&]() {
+            std::vector<size_t> items;
+            for (size_t i = 1; i <= num_items; ++i) {
+                items.push_back(i);
+            }
+            std::span<size_t> rest(items);
+            while (!rest.empty()) {
+                int r = channel.try_push_many(rest.first(
+                    std::min(rest.size(), size_t(5))));
+                if (r > 0) {
+                    rest = rest.subspan(r);
+                } else {
+                    REQUIRE(r == -EAGAIN);
+                    std::this_thread::yield();
+                }
+            }
+        });
+        threads.emplace_back([&]() {
+            size_t popped = 0;
+            size_t out[3];
+            while (popped < num_items) {
+                size_t n = std::min(num_items - popped, size_t(3));
+                int r = channel.try_pop_many(std::span(out).first(n));
+                if (r > 0) {
+                    for (int i = 0; i < r; ++i) {
+                        sum += out[i];
+                    }
+                    popped += r;
+                } else {
+                    REQUIRE(r == -EAGAIN);
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    REQUIRE(sum == num_threads * num_items * (num_items + 1) / 2);
+    REQUIRE(channel.empty());
+}
+
+TEST_CASE("test channel - cross runtimes multi producer and consumer") {
+    const size_t num_runtimes = 4;
+    const size_t num_items = 1000;
+
+    condy::Channel<size_t> channel(4);
+
+    std::atomic_size_t sum = 0;
+    auto producer = [&]() -> condy::Coro<void> {
+        for (size_t i = 1; i <= num_items; ++i) {
+            int r = co_await channel.push(size_t(i));
+            REQUIRE(r == 0);
+        }
+    };
+
+    auto consumer = [&]() -> condy::Coro<void> {
+        for (size_t i = 1; i <= num_items; ++i) {
+            auto [r, item] = co_await channel.pop();
+            REQUIRE(r == 0);
+            sum += item;
+        }
+    };
+
+    std::vector<std::unique_ptr<condy::Runtime>> runtimes;
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < num_runtimes; ++i) {
+        runtimes.push_back(std::make_unique<condy::Runtime>(options));
+    }
+    for (auto &runtime : runtimes) {
+        threads.emplace_back([&runtime]() { runtime->run(); });
+    }
+
+    std::vector<condy::Task<void>> tasks;
+    for (size_t i = 0; i < num_runtimes; ++i) {
+        if (i % 2 == 0) {
+            tasks.push_back(condy::co_spawn(*runtimes[i], producer()));
+        } else {
+            tasks.push_back(condy::co_spawn(*runtimes[i], consumer()));
+        }
+    }
+    for (auto &task : tasks) {
+        task.wait();
+    }
+
+    for (auto &runtime : runtimes) {
+        runtime->allow_exit();
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    REQUIRE(sum == num_runtimes / 2 * num_items * (num_items + 1) / 2);
+    REQUIRE(channel.empty());
+}
+
 TEST_CASE("test channel - cross runtimes with unbuffered channel") {
     condy::Runtime runtime1(options), runtime2(options);
 
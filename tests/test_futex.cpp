@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <atomic>
 #include <doctest/doctest.h>
+#include <memory>
 #include <queue>
 #include <thread>
 #include <vector>
@@ -118,26 +119,96 @@ TEST_CASE("test async_futex - cancel") {
     condy::sync_wait(wait_func());
 }
 
-TEST_CASE("test async_futex - destroy while waiting") {
+TEST_CASE("test async_futex - destroy another futex while waiting") {
     std::atomic<int> atomic_counter = 0;
-    std::unique_ptr<condy::Futex<int>> futex =
-        std::make_unique<condy::Futex<int>>(atomic_counter);
+    condy::Futex<int> futex(atomic_counter);
 
-    auto destroy_func = [&]() -> condy::Coro<void> {
-        futex.reset();
-        co_return;
+    auto notify_func = [&]() -> condy::Coro<void> {
+        {
+            // Another reference to the same atomic variable
+            condy::Futex<int> other(atomic_counter);
+        }
+        co_await condy::async_nop();
+        atomic_counter++;
+        futex.notify_one();
     };
 
     auto wait_func = [&]() -> condy::Coro<void> {
-        auto t = condy::co_spawn(destroy_func());
-        auto r = co_await futex->wait(0);
-        REQUIRE(r == -EIDRM);
+        auto t = condy::co_spawn(notify_func());
+        auto r = co_await futex.wait(0);
+        REQUIRE(r == 0);
+        REQUIRE(atomic_counter.load() == 1);
         co_await t;
     };
 
     condy::sync_wait(wait_func());
 }
 
+TEST_CASE("test async_futex - destroy the futex while waiting") {
+    std::atomic<int> atomic_counter = 0;
+    auto futex = std::make_unique<condy::Futex<int>>(atomic_counter);
+
+    auto wait_func = [&]() -> condy::Coro<void> {
+        auto sender = futex->wait(0);
+        futex.reset();
+        // The wait is canceled after the futex is gone
+        auto r = co_await condy::when_any(std::move(sender),
+                                          condy::async_nop());
+        REQUIRE(r.index() == 1);
+        REQUIRE(atomic_counter.load() == 0);
+    };
+
+    condy::sync_wait(wait_func());
+}
+
+TEST_CASE("test async_futex - notify by address") {
+    // Only a reference to the atomic variable
+    REQUIRE(sizeof(condy::Futex<int>) == sizeof(void *));
+
+    // Enough futexes to share shards of the parking lot
+    constexpr size_t num_futexes = 1024;
+    std::vector<std::atomic<int>> atomics(num_futexes);
+    std::vector<std::unique_ptr<condy::Futex<int>>> futexes;
+    for (auto &atomic : atomics) {
+        futexes.push_back(std::make_unique<condy::Futex<int>>(atomic));
+    }
+
+    std::vector<int> finished(num_futexes, false);
+
+    auto wait_func = [&](size_t no) -> condy::Coro<void> {
+        co_await futexes[no]->wait(0);
+        REQUIRE(atomics[no].load() == 1);
+        finished[no] = true;
+    };
+
+    auto wake_func = [&]() -> condy::Coro<void> {
+        // Wake up in reverse order, one futex at a time
+        for (size_t i = num_futexes; i-- > 0;) {
+            REQUIRE(!finished[i]);
+            atomics[i]++;
+            futexes[i]->notify_all();
+            co_await condy::async_nop();
+            REQUIRE(finished[i]);
+            REQUIRE(std::none_of(finished.begin(), finished.begin() + i,
+                                 [](int f) { return f; }));
+        }
+    };
+
+    auto func = [&]() -> condy::Coro<void> {
+        std::vector<condy::Task<void>> tasks;
+        for (size_t i = 0; i < num_futexes; i++) {
+            tasks.push_back(condy::co_spawn(wait_func(i)));
+        }
+        co_await condy::async_nop();
+        co_await condy::co_spawn(wake_func());
+        for (auto &t : tasks) {
+            co_await t;
+        }
+    };
+
+    condy::sync_wait(func());
+}
+
 namespace {
 
 class FutexSemaphore {
@@ -0,0 +1,162 @@
+#include "condy/async_operations.hpp"
+#include "condy/awaiter_operations.hpp"
+#include "condy/channel.hpp"
+#include "condy/coro.hpp"
+#include "condy/interval.hpp"
+#include "condy/runtime.hpp"
+#include "condy/runtime_options.hpp"
+#include "condy/sync_wait.hpp"
+#include "condy/task.hpp"
+#include "condy/timer.hpp"
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <doctest/doctest.h>
+#include <functional>
+#include <stop_token>
+#include <thread>
+
+#if !IO_URING_CHECK_VERSION(2, 4) // >= 2.4
+
+namespace {
+
+auto options = condy::RuntimeOptions().sq_size(8).cq_size(16);
+
+struct WithCancelReceiver {
+    std::function<void(int)> callback;
+    std::stop_token token;
+    void operator()(int result) noexcept { callback(result); }
+    auto get_stop_token() const noexcept { return token; }
+};
+
+} // namespace
+
+TEST_CASE("test interval - tick") {
+    using namespace std::chrono_literals;
+
+    auto func = [&]() -> condy::Coro<void> {
+        condy::Interval interval(10ms);
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < 5; ++i) {
+            REQUIRE(co_await interval.tick() >= 0);
+        }
+        REQUIRE(std::chrono::steady_clock::now() - start >= 50ms);
+    };
+
+    condy::Runtime runtime(options);
+    condy::sync_wait(runtime, func());
+    // A single timeout for all ticks, plus the cancellation on destruction
+    REQUIRE(runtime.stats().submitted_sqes < 5);
+}
+
+TEST_CASE("test interval - burst missed ticks") {
+    using namespace std::chrono_literals;
+
+    auto func = [&]() -> condy::Coro<void> {
+        condy::Interval interval(10ms, condy::MissedTickPolicy::Burst);
+        REQUIRE(co_await interval.tick() >= 0);
+        // Block the runtime thread, so that ticks are missed
+        std::this_thread::sleep_for(45ms);
+        int missed = co_await interval.tick();
+        REQUIRE(missed >= 1);
+        // The missed ticks are returned back-to-back
+        for (int i = missed - 1; i >= 0; --i) {
+            REQUIRE(co_await interval.tick() == i);
+        }
+    };
+
+    condy::Runtime runtime(options);
+    condy::sync_wait(runtime, func());
+}
+
+TEST_CASE("test interval - skip missed ticks") {
+    using namespace std::chrono_literals;
+
+    for (auto policy :
+         {condy::MissedTickPolicy::Skip, condy::MissedTickPolicy::Delay}) {
+        auto func = [&]() -> condy::Coro<void> {
+            condy::Interval interval(10ms, policy);
+            REQUIRE(co_await interval.tick() >= 0);
+            std::this_thread::sleep_for(45ms);
+            REQUIRE(co_await interval.tick() >= 1);
+            // The missed ticks are dropped, not returned by the next tick
+            REQUIRE(co_await interval.tick() == 0);
+        };
+
+        condy::Runtime runtime(options);
+        condy::sync_wait(runtime, func());
+    }
+}
+
+TEST_CASE("test interval - cancel tick") {
+    using condy::operators::operator||;
+    using namespace std::chrono_literals;
+
+    auto func = [&]() -> condy::Coro<void> {
+        condy::Interval interval(10s);
+        auto r = co_await (interval.tick() || condy::async_nop());
+        REQUIRE(r.index() == 1);
+        // The interval keeps running after a cancelled tick
+        auto start = std::chrono::steady_clock::now();
+        auto r2 = co_await (interval.tick() || condy::async_sleep(5ms));
+        REQUIRE(r2.index() == 1);
+        REQUIRE(std::chrono::steady_clock::now() - start < 5s);
+    };
+
+    condy::Runtime runtime(options);
+    condy::sync_wait(runtime, func());
+}
+
+TEST_CASE("test interval - cancel tick from other thread") {
+    using namespace std::chrono_literals;
+
+    condy::Runtime runtime(options);
+    condy::Channel<int> channel(1);
+    std::stop_source stop_source;
+    std::atomic_bool started = false;
+
+    auto func = [&]() -> condy::Coro<void> {
+        condy::Interval interval(10s);
+        auto op_state = interval.tick().connect(WithCancelReceiver{
+            .callback = [&](int r) { REQUIRE(channel.try_push(r) == 0); },
+            .token = stop_source.get_token(),
+        });
+        op_state.start(0);
+        started = true;
+        started.notify_one();
+        auto [r, item] = co_await channel.pop();
+        REQUIRE(r == 0);
+        REQUIRE(item == -ECANCELED);
+    };
+
+    condy::co_spawn(runtime, func()).detach();
+
+    std::thread t([&]() {
+        runtime.allow_exit();
+        runtime.run();
+    });
+
+    started.wait(false);
+    stop_source.request_stop();
+
+    t.join();
+}
+
+TEST_CASE("test interval - destroy while armed") {
+    using namespace std::chrono_literals;
+
+    auto func = [&]() -> condy::Coro<void> {
+        for (int i = 0; i < 10; ++i) {
+            condy::Interval interval(1ms);
+            REQUIRE(co_await interval.tick() >= 0);
+        }
+        // Never ticked, nothing submitted
+        condy::Interval idle(1ms);
+    };
+
+    // The runtime exits once the timeouts are removed
+    condy::Runtime runtime(options);
+    condy::sync_wait(runtime, func());
+}
+
+#endif
@@ -1,6 +1,8 @@
 #include "condy/intrusive.hpp"
 #include <doctest/doctest.h>
+#include <thread>
 #include <utility>
+#include <vector>
 
 TEST_CASE("test intrusive - single list") {
     using namespace condy;
@@ -131,6 +133,9 @@ TEST_CASE("test intrusive - double list") {
     list.push_back(&item4);
 
     REQUIRE(!list.empty());
+    REQUIRE(list.front() == &item1);
+    REQUIRE(list.next(&item1) == &item2);
+    REQUIRE(list.next(&item4) == nullptr);
 
     Item *popped = list.pop_front();
     REQUIRE(popped->value == 1);
@@ -185,3 +190,85 @@ TEST_CASE("test intrusive - double list move") {
     REQUIRE(list.pop_front()->value == 4);
     REQUIRE(list.empty());
 }
+
+TEST_CASE("test intrusive - mpsc list") {
+    using namespace condy;
+
+    struct Item {
+        int value;
+        SingleLinkEntry link = {};
+    };
+
+    IntrusiveMpscList<Item, &Item::link> list;
+
+    REQUIRE(list.empty());
+    REQUIRE(list.pop_all().empty());
+
+    Item item1{1};
+    Item item2{2};
+    Item item3{3};
+
+    list.push(&item1);
+    list.push(&item2);
+    list.push(&item3);
+    REQUIRE(!list.empty());
+
+    auto popped = list.pop_all();
+    REQUIRE(list.empty());
+    REQUIRE(popped.pop_front()->value == 1);
+    REQUIRE(popped.pop_front()->value == 2);
+    REQUIRE(popped.pop_front()->value == 3);
+    REQUIRE(popped.empty());
+
+    list.push(&item2);
+    popped = list.pop_all();
+    REQUIRE(popped.pop_front()->value == 2);
+    REQUIRE(popped.empty());
+}
+
+TEST_CASE("test intrusive - mpsc list concurrent push") {
+    using namespace condy;
+
+    struct Item {
+        int producer;
+        int value;
+        SingleLinkEntry link = {};
+    };
+
+    const int num_threads = 4;
+    const int num_items = 1000;
+
+    IntrusiveMpscList<Item, &Item::link> list;
+    std::vector<std::vector<Item>> items(num_threads);
+    for (int t = 0; t < num_threads; t++) {
+        for (int i = 0; i < num_items; i++) {
+            items[t].push_back(Item{t, i});
+        }
+    }
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&, t]() {
+            for (auto &item : items[t]) {
+                list.push(&item);
+            }
+        });
+    }
+
+    std::vector<int> last(num_threads, -1);
+    int total = 0;
+    while (total < num_threads * num_items) {
+        auto popped = list.pop_all();
+        while (auto *item = popped.pop_front()) {
+            // Items from the same producer keep their order
+            REQUIRE(item->value == last[item->producer] + 1);
+            last[item->producer] = item->value;
+            total++;
+        }
+    }
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    REQUIRE(list.empty());
+}
@@ -0,0 +1,189 @@
+#include "condy/async_operations.hpp"
+#include "condy/awaiter_operations.hpp"
+#include "condy/coro.hpp"
+#include "condy/local_channel.hpp"
+#include "condy/runtime.hpp"
+#include "condy/runtime_options.hpp"
+#include "condy/sync_wait.hpp"
+#include "condy/task.hpp"
+#include <cerrno>
+#include <cstddef>
+#include <doctest/doctest.h>
+#include <memory>
+#include <type_traits>
+
+namespace {
+
+auto options = condy::RuntimeOptions().sq_size(8).cq_size(16);
+
+} // namespace
+
+TEST_CASE("test local_channel - no atomic operations") {
+    using Policy = condy::detail::LocalChannelPolicy;
+    // The ring buffer, its indices and the counters are plain integers
+    static_assert(std::is_same_v<Policy::Mutex, condy::detail::NullMutex>);
+    static_assert(std::is_same_v<Policy::Atomic<size_t>,
+                                 condy::detail::PlainAtomic<size_t>>);
+    static_assert(std::is_same_v<Policy::AtomicRef<size_t>,
+                                 condy::detail::PlainAtomic<size_t &>>);
+    static_assert(sizeof(Policy::Atomic<size_t>) == sizeof(size_t));
+
+    size_t value = 1;
+    Policy::AtomicRef<size_t> ref(value);
+    REQUIRE(ref.fetch_add(2) == 1);
+    REQUIRE(ref.fetch_sub(1) == 3);
+    size_t expected = 1;
+    REQUIRE(!ref.compare_exchange_weak(expected, 5));
+    REQUIRE(expected == 2);
+    REQUIRE(ref.compare_exchange_weak(expected, 5));
+    REQUIRE(value == 5);
+}
+
+TEST_CASE("test local_channel - try push and pop") {
+    condy::LocalChannel<int> channel(2);
+
+    REQUIRE(channel.capacity() == 2);
+    REQUIRE(channel.empty());
+
+    REQUIRE(channel.try_push(1) == 0);
+    REQUIRE(channel.try_push(2) == 0);
+    REQUIRE(channel.try_push(3) == -EAGAIN);
+    REQUIRE(channel.size() == 2);
+
+    auto [r1, item1] = channel.try_pop();
+    REQUIRE(r1 == 0);
+    REQUIRE(item1 == 1);
+
+    auto [r2, item2] = channel.try_pop();
+    REQUIRE(r2 == 0);
+    REQUIRE(item2 == 2);
+
+    auto [r3, item3] = channel.try_pop();
+    REQUIRE(r3 == -EAGAIN);
+
+    channel.push_close();
+    REQUIRE(channel.is_closed());
+    REQUIRE(channel.try_push(4) == -EPIPE);
+    auto [r4, item4] = channel.try_pop();
+    REQUIRE(r4 == -EPIPE);
+}
+
+TEST_CASE("test local_channel - push and pop with coroutines") {
+    condy::LocalChannel<int> channel(2);
+
+    const size_t max_items = 41;
+
+    size_t finished = 0;
+    auto producer = [&]() -> condy::Coro<void> {
+        for (size_t i = 1; i <= max_items; ++i) {
+            co_await channel.push(static_cast<int>(i));
+        }
+        finished++;
+    };
+
+    auto consumer = [&]() -> condy::Coro<void> {
+        for (size_t i = 1; i <= max_items; ++i) {
+            auto [r, item] = co_await channel.pop();
+            REQUIRE(r == 0);
+            REQUIRE(item == i);
+        }
+        finished++;
+    };
+
+    auto func = [&]() -> condy::Coro<void> {
+        auto t1 = condy::co_spawn(producer());
+        auto t2 = condy::co_spawn(consumer());
+        co_await std::move(t1);
+        co_await std::move(t2);
+    };
+
+    condy::Runtime runtime(options);
+    condy::sync_wait(runtime, func());
+    REQUIRE(finished == 2);
+}
+
+TEST_CASE("test local_channel - unbuffered channel") {
+    condy::LocalChannel<std::unique_ptr<int>> channel(0);
+
+    const int max_items = 100;
+
+    auto producer = [&]() -> condy::Coro<void> {
+        for (int i = 1; i <= max_items; ++i) {
+            int r = co_await channel.push(std::make_unique<int>(i));
+            REQUIRE(r == 0);
+        }
+        channel.push_close();
+    };
+
+    auto consumer = [&]() -> condy::Coro<void> {
+        for (int i = 1; i <= max_items; ++i) {
+            auto [r, item] = co_await channel.pop();
+            REQUIRE(r == 0);
+            REQUIRE(*item == i);
+        }
+        auto [r, item] = co_await channel.pop();
+        REQUIRE(r == -EPIPE);
+    };
+
+    auto func = [&]() -> condy::Coro<void> {
+        auto t1 = condy::co_spawn(consumer());
+        auto t2 = condy::co_spawn(producer());
+        co_await std::move(t1);
+        co_await std::move(t2);
+    };
+
+    condy::Runtime runtime(options);
+    condy::sync_wait(runtime, func());
+}
+
+TEST_CASE("test local_channel - cancel pop") {
+    using condy::operators::operator||;
+
+    condy::LocalChannel<int> ch1(1), ch2(1);
+
+    auto pusher = [&]() -> condy::Coro<void> {
+        REQUIRE(co_await ch2.push(43) == 0);
+    };
+
+    auto func = [&]() -> condy::Coro<void> {
+        __kernel_timespec ts{
+            .tv_sec = 0,
+            .tv_nsec = 1000000,
+        };
+        auto r = co_await (ch1.pop() || condy::async_timeout(&ts, 0, 0));
+        REQUIRE(r.index() == 1);
+
+        // The canceled pop must not take the item
+        REQUIRE(ch1.try_push(42) == 0);
+        auto [r2, item] = co_await ch1.pop();
+        REQUIRE(r2 == 0);
+        REQUIRE(item == 42);
+
+        auto t = condy::co_spawn(pusher());
+        auto [r3, item3] = co_await ch2.pop();
+        REQUIRE(r3 == 0);
+        REQUIRE(item3 == 43);
+        co_await std::move(t);
+    };
+
+    condy::Runtime runtime(options);
+    condy::sync_wait(runtime, func());
+}
+
+TEST_CASE("test local_channel - force push") {
+    condy::LocalChannel<int> channel(1);
+
+    auto func = [&]() -> condy::Coro<void> {
+        channel.force_push(1);
+        channel.force_push(2);
+        channel.force_push(3);
+        for (int i = 1; i <= 3; ++i) {
+            auto [r, item] = co_await channel.pop();
+            REQUIRE(r == 0);
+            REQUIRE(item == i);
+        }
+    };
+
+    condy::Runtime runtime(options);
+    condy::sync_wait(runtime, func());
+}
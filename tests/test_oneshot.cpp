@@ -0,0 +1,148 @@
+#include "condy/async_operations.hpp"
+#include "condy/awaiter_operations.hpp"
+#include "condy/channel.hpp"
+#include "condy/coro.hpp"
+#include "condy/oneshot.hpp"
+#include "condy/runtime.hpp"
+#include "condy/runtime_options.hpp"
+#include "condy/sync_wait.hpp"
+#include "condy/task.hpp"
+#include <cerrno>
+#include <doctest/doctest.h>
+#include <memory>
+#include <thread>
+
+namespace {
+
+auto options = condy::RuntimeOptions().sq_size(8).cq_size(16);
+
+} // namespace
+
+TEST_CASE("test oneshot - try recv") {
+    condy::Oneshot<std::unique_ptr<int>> oneshot;
+    REQUIRE(!oneshot.is_ready());
+    REQUIRE(oneshot.try_recv().first == -EAGAIN);
+
+    REQUIRE(oneshot.send(std::make_unique<int>(42)) == 0);
+    REQUIRE(oneshot.is_ready());
+    REQUIRE(oneshot.send(std::make_unique<int>(43)) == -EPIPE);
+
+    auto [r, item] = oneshot.try_recv();
+    REQUIRE(r == 0);
+    REQUIRE(*item == 42);
+    REQUIRE(oneshot.try_recv().first == -EPIPE);
+}
+
+TEST_CASE("test oneshot - close") {
+    condy::Oneshot<int> oneshot;
+    oneshot.close();
+    oneshot.close();
+    REQUIRE(oneshot.send(1) == -EPIPE);
+    REQUIRE(oneshot.try_recv().first == -EPIPE);
+
+    // Close after send does nothing
+    condy::Oneshot<int> oneshot2;
+    REQUIRE(oneshot2.send(1) == 0);
+    oneshot2.close();
+    auto [r, item] = oneshot2.try_recv();
+    REQUIRE(r == 0);
+    REQUIRE(item == 1);
+
+    // Destruct without receiving
+    auto ptr = std::make_shared<int>(1);
+    {
+        condy::Oneshot<std::shared_ptr<int>> oneshot3;
+        REQUIRE(oneshot3.send(std::shared_ptr<int>(ptr)) == 0);
+        REQUIRE(ptr.use_count() == 2);
+    }
+    REQUIRE(ptr.use_count() == 1);
+}
+
+TEST_CASE("test oneshot - recv with coroutines") {
+    condy::Oneshot<int> oneshot, closed;
+
+    auto sender = [&]() -> condy::Coro<void> {
+        REQUIRE(oneshot.send(42) == 0);
+        closed.close();
+        co_return;
+    };
+
+    auto func = [&]() -> condy::Coro<void> {
+        auto t = condy::co_spawn(sender());
+        auto [r1, item] = co_await oneshot.recv();
+        REQUIRE(r1 == 0);
+        REQUIRE(item == 42);
+        auto [r2, item2] = co_await closed.recv();
+        REQUIRE(r2 == -EPIPE);
+        co_await std::move(t);
+    };
+
+    condy::Runtime runtime(options);
+    condy::sync_wait(runtime, func());
+}
+
+TEST_CASE("test oneshot - cancel recv") {
+    using condy::operators::operator||;
+
+    condy::Oneshot<int> oneshot;
+
+    auto func = [&]() -> condy::Coro<void> {
+        __kernel_timespec ts{
+            .tv_sec = 0,
+            .tv_nsec = 1000000,
+        };
+        auto r = co_await (oneshot.recv() || condy::async_timeout(&ts, 0, 0));
+        REQUIRE(r.index() == 1);
+
+        REQUIRE(oneshot.send(42) == 0);
+        auto [r2, item] = co_await oneshot.recv();
+        REQUIRE(r2 == 0);
+        REQUIRE(item == 42);
+    };
+
+    condy::Runtime runtime(options);
+    condy::sync_wait(runtime, func());
+}
+
+TEST_CASE("test oneshot - cross runtimes") {
+    struct Request {
+        int value;
+        condy::Oneshot<int> *reply;
+    };
+    condy::Channel<Request> requests(16);
+
+    const int num_requests = 1000;
+
+    auto server = [&]() -> condy::Coro<void> {
+        while (true) {
+            auto [r, request] = co_await requests.pop();
+            if (r == -EPIPE) {
+                break;
+            }
+            REQUIRE(request.reply->send(request.value * 2) == 0);
+        }
+    };
+
+    auto client = [&]() -> condy::Coro<void> {
+        for (int i = 0; i < num_requests; ++i) {
+            condy::Oneshot<int> reply;
+            REQUIRE(co_await requests.push(Request{i, &reply}) == 0);
+            auto [r, item] = co_await reply.recv();
+            REQUIRE(r == 0);
+            REQUIRE(item == i * 2);
+        }
+        requests.push_close();
+    };
+
+    condy::Runtime server_runtime(options);
+    auto task = condy::co_spawn(server_runtime, server());
+    std::thread t([&]() {
+        server_runtime.allow_exit();
+        server_runtime.run();
+    });
+
+    condy::Runtime runtime(options);
+    condy::sync_wait(runtime, client());
+    task.wait();
+    t.join();
+}
@@ -1,7 +1,9 @@
+#include "condy/block_cache.hpp"
 #include "condy/context.hpp"
 #include "condy/cqe_handler.hpp"
 #include "condy/finish_handles.hpp"
 #include "condy/runtime.hpp"
+#include "condy/utils.hpp"
 #include <cstddef>
 #include <cstring>
 #include <doctest/doctest.h>
@@ -160,4 +162,35 @@ TEST_CASE("test op_finish_handle - zero copy op") {
     REQUIRE(op_finish2);
     REQUIRE(invoke_count == 1);
     REQUIRE(res == 2);
-}
\ No newline at end of file
+}
+
+TEST_CASE("test op_finish_handle - zero copy op with block cache") {
+    condy::detail::BlockCache cache;
+    condy::detail::Context::current().init(nullptr, nullptr, &cache);
+    auto d = condy::defer([]() { condy::detail::Context::current().reset(); });
+
+    size_t invoke_count = 0;
+    int r = 0;
+    MockReceiver receiver{invoke_count, r};
+    auto func = [](int) {};
+    using Handle = condy::ZeroCopyOpFinishHandle<condy::SimpleCQEHandler,
+                                                 decltype(func), MockReceiver>;
+
+    void *first = nullptr;
+    for (int i = 0; i < 3; i++) {
+        auto *handle = new Handle(condy::SimpleCQEHandler(), receiver, func);
+        if (first == nullptr) {
+            first = handle;
+        } else {
+            // Freed by the notification, then recycled
+            REQUIRE(static_cast<void *>(handle) == first);
+        }
+        io_uring_cqe cqe{};
+        cqe.flags |= IORING_CQE_F_MORE;
+        REQUIRE(!handle->handle(&cqe));
+        io_uring_cqe cqe2{};
+        cqe2.flags |= IORING_CQE_F_NOTIF;
+        REQUIRE(handle->handle(&cqe2));
+    }
+    REQUIRE(invoke_count == 3);
+}
@@ -138,3 +138,39 @@ TEST_CASE("test ring - cancel ops") {
 
     ring.destroy();
 }
+
+TEST_CASE("test ring - reap completions with prefetch") {
+    Ring ring;
+    io_uring_params params{};
+    std::memset(&params, 0, sizeof(params));
+    ring.init(64, &params);
+
+    constexpr size_t num_ops = 40;
+    for (size_t i = 0; i < num_ops; i++) {
+        auto *sqe = ring.get_sqe();
+        io_uring_prep_nop(sqe);
+        io_uring_sqe_set_data64(sqe, i);
+    }
+
+    std::vector<uint64_t> prefetched;
+    std::vector<uint64_t> processed;
+    size_t reaped = 0;
+    while (reaped < num_ops) {
+        ring.submit();
+        reaped += ring.reap_completions(
+            [&](io_uring_cqe *cqe) {
+                auto data = io_uring_cqe_get_data64(cqe);
+                // Each CQE is prefetched before it is processed
+                REQUIRE(prefetched.size() > processed.size());
+                processed.push_back(data);
+            },
+            [&](io_uring_cqe *cqe) {
+                prefetched.push_back(io_uring_cqe_get_data64(cqe));
+            });
+    }
+
+    REQUIRE(processed.size() == num_ops);
+    REQUIRE(prefetched == processed);
+
+    ring.destroy();
+}
@@ -0,0 +1,113 @@
+#include "condy/invoker.hpp"
+#include "condy/priority.hpp"
+#include "condy/run_queue.hpp"
+#include <cstddef>
+#include <doctest/doctest.h>
+#include <vector>
+
+namespace {
+
+struct Work : public condy::WorkInvoker {
+    Work(int id, condy::TaskPriority priority) : id(id) {
+        set_priority(priority);
+    }
+    int id;
+};
+
+std::vector<int> drain(condy::detail::RunQueue &queue) {
+    std::vector<int> ids;
+    while (auto *work = queue.pop_front()) {
+        ids.push_back(static_cast<Work *>(work)->id);
+    }
+    return ids;
+}
+
+} // namespace
+
+TEST_CASE("test run_queue - strict priority") {
+    using condy::TaskPriority;
+
+    condy::detail::RunQueue queue;
+    REQUIRE(queue.empty());
+    REQUIRE(queue.pop_front() == nullptr);
+
+    Work w1(1, TaskPriority::Low), w2(2, TaskPriority::Normal),
+        w3(3, TaskPriority::High), w4(4, TaskPriority::Normal),
+        w5(5, TaskPriority::High);
+    for (auto *work : {&w1, &w2, &w3, &w4, &w5}) {
+        queue.push_back(work);
+    }
+    REQUIRE(!queue.empty());
+    // FIFO within the same priority
+    REQUIRE(drain(queue) == std::vector<int>{3, 5, 2, 4, 1});
+    REQUIRE(queue.empty());
+}
+
+TEST_CASE("test run_queue - push list") {
+    using condy::TaskPriority;
+
+    condy::detail::RunQueue queue;
+    Work w1(1, TaskPriority::Normal), w2(2, TaskPriority::High),
+        w3(3, TaskPriority::Normal);
+    condy::detail::RunQueue::WorkList list;
+    for (auto *work : {&w1, &w2, &w3}) {
+        list.push_back(work);
+    }
+    queue.push_back(std::move(list));
+    REQUIRE(drain(queue) == std::vector<int>{2, 1, 3});
+}
+
+TEST_CASE("test run_queue - aging") {
+    using condy::TaskPriority;
+    const size_t threshold = condy::detail::RunQueue::aging_threshold;
+
+    condy::detail::RunQueue queue;
+    Work low(-1, TaskPriority::Low);
+    Work normal(-2, TaskPriority::Normal);
+    std::vector<Work> highs;
+    for (size_t i = 0; i < threshold * 2; ++i) {
+        highs.emplace_back(static_cast<int>(i), TaskPriority::High);
+    }
+    queue.push_back(&low);
+    queue.push_back(&normal);
+    for (auto &work : highs) {
+        queue.push_back(&work);
+    }
+
+    auto ids = drain(queue);
+    REQUIRE(ids.size() == threshold * 2 + 2);
+    // Lower priorities are served once passed over too many times
+    REQUIRE(ids[threshold - 1] == -1);
+    REQUIRE(ids[threshold] == -2);
+    REQUIRE(ids.back() == static_cast<int>(threshold * 2 - 1));
+}
+
+TEST_CASE("test run_queue - aging after refill") {
+    using condy::TaskPriority;
+    const size_t threshold = condy::detail::RunQueue::aging_threshold;
+
+    condy::detail::RunQueue queue;
+    Work low(-1, TaskPriority::Low);
+    std::vector<Work> highs;
+    for (size_t i = 0; i < threshold * 2; ++i) {
+        highs.emplace_back(static_cast<int>(i), TaskPriority::High);
+    }
+
+    // Passed over a few times, then served once higher levels are drained
+    queue.push_back(&low);
+    for (size_t i = 0; i < threshold / 2; ++i) {
+        queue.push_back(&highs[i]);
+    }
+    auto ids = drain(queue);
+    REQUIRE(ids.size() == threshold / 2 + 1);
+    REQUIRE(ids.back() == -1);
+
+    // The refilled level waits for a full threshold again
+    queue.push_back(&low);
+    for (auto &work : highs) {
+        queue.push_back(&work);
+    }
+    ids = drain(queue);
+    REQUIRE(ids.size() == threshold * 2 + 1);
+    REQUIRE(ids[threshold - 1] == -1);
+}
@@ -1,6 +1,7 @@
 #include "condy/awaiter_operations.hpp"
 #include "condy/coro.hpp"
 #include "condy/invoker.hpp"
+#include "condy/local_channel.hpp"
 #include "condy/runtime.hpp"
 #include "condy/runtime_options.hpp"
 #include "condy/task.hpp"
@@ -249,3 +250,39 @@ TEST_CASE("test runtime - allow_exit from other thread") {
 
     t1.join();
 }
+
+TEST_CASE("test runtime - task budget") {
+    const size_t num_items = 1000;
+
+    for (size_t budget : {size_t(0), size_t(16)}) {
+        condy::Runtime runtime(
+            condy::RuntimeOptions(options).task_budget(budget));
+        condy::LocalChannel<size_t> channel(num_items);
+
+        size_t pushed_before_other = num_items + 1;
+        auto producer = [&]() -> condy::Coro<void> {
+            // Every push completes synchronously
+            for (size_t i = 0; i < num_items; ++i) {
+                REQUIRE(co_await channel.push(i) == 0);
+            }
+        };
+        auto other = [&]() -> condy::Coro<void> {
+            pushed_before_other = channel.size();
+            co_return;
+        };
+
+        condy::co_spawn(runtime, producer()).detach();
+        condy::co_spawn(runtime, other()).detach();
+        runtime.allow_exit();
+        runtime.run();
+
+        if (budget == 0) {
+            REQUIRE(pushed_before_other == num_items);
+            REQUIRE(runtime.stats().budget_yields == 0);
+        } else {
+            // The completion after the budget is used up is deferred
+            REQUIRE(pushed_before_other == budget + 1);
+            REQUIRE(runtime.stats().budget_yields == num_items / (budget + 1));
+        }
+    }
+}
@@ -4,9 +4,11 @@
 #include "condy/runtime.hpp"
 #include "condy/sync_wait.hpp"
 #include "condy/task.hpp"
+#include <chrono>
 #include <doctest/doctest.h>
 #include <fcntl.h>
 #include <limits>
+#include <stdexcept>
 
 TEST_CASE("test runtime_options - event_interval") {
     condy::RuntimeOptions options;
@@ -34,6 +36,164 @@ TEST_CASE("test runtime_options - event_interval") {
     condy::sync_wait(runtime, func());
 }
 
+TEST_CASE("test runtime_options - enable_adaptive_event_interval") {
+    REQUIRE_THROWS_AS(condy::RuntimeOptions().enable_adaptive_event_interval(0),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(
+        condy::RuntimeOptions().enable_adaptive_event_interval(8, 4),
+        std::invalid_argument);
+
+    auto cpu_bound = [](condy::Runtime &runtime) {
+        auto func = [&]() -> condy::Coro<void> {
+            auto noop = []() -> condy::Coro<void> { co_return; };
+            for (int i = 0; i < 10000; i++) {
+                condy::co_spawn(noop()).detach();
+            }
+            co_return;
+        };
+        condy::sync_wait(runtime, func());
+    };
+
+    condy::RuntimeOptions options;
+    options.event_interval(1);
+    condy::Runtime fixed_runtime(options);
+    cpu_bound(fixed_runtime);
+    REQUIRE(fixed_runtime.stats().empty_event_checks >= 10000);
+
+    options.enable_adaptive_event_interval(1, 1024);
+    condy::Runtime adaptive_runtime(options);
+    cpu_bound(adaptive_runtime);
+    REQUIRE(adaptive_runtime.stats().empty_event_checks < 100);
+}
+
+namespace {
+
+void run_nop_tasks(condy::Runtime &runtime, int num_tasks, int num_nops) {
+    auto task_func = [&]() -> condy::Coro<void> {
+        for (int i = 0; i < num_nops; i++) {
+            co_await condy::async_nop();
+        }
+    };
+
+    auto func = [&]() -> condy::Coro<void> {
+        std::vector<condy::Task<void>> tasks;
+        tasks.reserve(num_tasks);
+        for (int i = 0; i < num_tasks; i++) {
+            tasks.push_back(condy::co_spawn(task_func()));
+        }
+
+        for (auto &t : tasks) {
+            co_await std::move(t);
+        }
+    };
+
+    condy::sync_wait(runtime, func());
+}
+
+} // namespace
+
+TEST_CASE("test runtime_options - default submit policy") {
+    condy::Runtime runtime;
+    run_nop_tasks(runtime, 16, 4);
+
+    auto &stats = runtime.stats();
+    REQUIRE(stats.submitted_sqes == 16 * 4);
+    // Queued SQEs are only submitted when the runtime runs out of tasks, so
+    // there is at most one submission per round of nops
+    REQUIRE(stats.submits <= 4);
+    REQUIRE(stats.max_submit_batch <= 16);
+}
+
+TEST_CASE("test runtime_options - submit_batch") {
+    condy::RuntimeOptions options;
+    options.submit_batch(4);
+    condy::Runtime runtime(options);
+    run_nop_tasks(runtime, 16, 4);
+
+    auto &stats = runtime.stats();
+    REQUIRE(stats.submitted_sqes == 16 * 4);
+    // Tasks resumed by the same batch of completions still submit together,
+    // but the first round is split into batches of 4
+    REQUIRE(stats.submits > 4);
+}
+
+TEST_CASE("test runtime_options - submit_latency") {
+    condy::RuntimeOptions options;
+    options.submit_latency(std::chrono::nanoseconds(1));
+    condy::Runtime runtime(options);
+    run_nop_tasks(runtime, 16, 4);
+
+    auto &stats = runtime.stats();
+    REQUIRE(stats.submitted_sqes == 16 * 4);
+    REQUIRE(stats.submits > 4);
+}
+
+TEST_CASE("test runtime_options - enable_submit_on_tick") {
+    condy::RuntimeOptions options;
+    options.event_interval(2).enable_submit_on_tick();
+    condy::Runtime runtime(options);
+    run_nop_tasks(runtime, 16, 4);
+
+    auto &stats = runtime.stats();
+    REQUIRE(stats.submitted_sqes == 16 * 4);
+    REQUIRE(stats.submits > 4);
+}
+
+TEST_CASE("test runtime_options - busy_poll") {
+    auto func = []() -> condy::Coro<void> {
+        __kernel_timespec ts{
+            .tv_sec = 0,
+            .tv_nsec = 1'000'000, // 1ms
+        };
+        int r = co_await condy::async_timeout(&ts, 0, 0);
+        REQUIRE(r == -ETIME);
+    };
+
+    condy::Runtime parking_runtime;
+    condy::sync_wait(parking_runtime, func());
+    REQUIRE(parking_runtime.stats().parks > 0);
+    REQUIRE(parking_runtime.stats().busy_polls == 0);
+
+    condy::RuntimeOptions options;
+    options.busy_poll(std::chrono::seconds(10));
+    condy::Runtime polling_runtime(options);
+    condy::sync_wait(polling_runtime, func());
+    auto &stats = polling_runtime.stats();
+    REQUIRE(stats.parks == 0);
+    REQUIRE(stats.busy_poll_hits > 0);
+    REQUIRE(stats.busy_poll_time > std::chrono::nanoseconds(0));
+}
+
+TEST_CASE("test runtime_options - wait_batch") {
+    REQUIRE_THROWS_AS(
+        condy::RuntimeOptions().wait_batch(0, std::chrono::microseconds(10)),
+        std::invalid_argument);
+    REQUIRE_THROWS_AS(
+        condy::RuntimeOptions().wait_batch(8, std::chrono::microseconds(0)),
+        std::invalid_argument);
+
+    condy::RuntimeOptions options;
+    options.wait_batch(8, std::chrono::microseconds(1000));
+
+    condy::Runtime runtime(options);
+    run_nop_tasks(runtime, 16, 4);
+    REQUIRE(runtime.stats().submitted_sqes == 16 * 4);
+
+    // Fewer completions than the batch size must not block forever
+    auto func = []() -> condy::Coro<void> {
+        __kernel_timespec ts{
+            .tv_sec = 0,
+            .tv_nsec = 5'000'000, // 5ms, longer than the batch timeout
+        };
+        int r = co_await condy::async_timeout(&ts, 0, 0);
+        REQUIRE(r == -ETIME);
+    };
+    condy::Runtime runtime2(options);
+    condy::sync_wait(runtime2, func());
+    // Counted even if the batched wait times out
+    REQUIRE(runtime2.stats().submitted_sqes == 1);
+}
+
 TEST_CASE("test runtime_options - enable_iopoll") {
     const char *nvme_device_path = std::getenv("CONDY_TEST_NVME_DEVICE_PATH");
     if (nvme_device_path == nullptr) {
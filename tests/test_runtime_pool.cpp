@@ -0,0 +1,149 @@
+#include "condy/runtime_options.hpp"
+#include "condy/runtime_pool.hpp"
+#include "condy/sync_wait.hpp"
+#include "condy/task.hpp"
+#include "condy/timer.hpp"
+#include <atomic>
+#include <chrono>
+#include <doctest/doctest.h>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+condy::RuntimeOptions options = condy::RuntimeOptions().sq_size(8).cq_size(16);
+
+} // namespace
+
+TEST_CASE("test runtime_pool - construct") {
+    REQUIRE_THROWS_AS(condy::RuntimePool(0, options), std::invalid_argument);
+
+    condy::RuntimePool pool(4, options);
+    REQUIRE(pool.size() == 4);
+    pool.allow_exit();
+    pool.run();
+}
+
+TEST_CASE("test runtime_pool - spawn from outside") {
+    condy::RuntimePool pool(4, options);
+
+    const size_t num_tasks = 64;
+    std::atomic_size_t count = 0;
+    auto func = [&]() -> condy::Coro<size_t> {
+        count++;
+        co_return 1;
+    };
+
+    std::vector<condy::Task<size_t>> tasks;
+    for (size_t i = 0; i < num_tasks; i++) {
+        tasks.push_back(condy::co_spawn(pool, func()));
+    }
+    pool.allow_exit();
+    pool.run();
+
+    size_t sum = 0;
+    for (auto &task : tasks) {
+        sum += task.wait();
+    }
+    REQUIRE(sum == num_tasks);
+    REQUIRE(count == num_tasks);
+}
+
+TEST_CASE("test runtime_pool - steal from busy runtime") {
+    condy::RuntimePool pool(2, options);
+
+    const size_t num_tasks = 16;
+    std::atomic_size_t count = 0;
+    std::thread::id spawner_id;
+    std::vector<std::thread::id> ids(num_tasks);
+
+    auto worker = [&](size_t i) -> condy::Coro<void> {
+        ids[i] = std::this_thread::get_id();
+        count++;
+        co_return;
+    };
+
+    auto spawner = [&]() -> condy::Coro<void> {
+        spawner_id = std::this_thread::get_id();
+        std::vector<condy::Task<void>> tasks;
+        for (size_t i = 0; i < num_tasks; i++) {
+            tasks.push_back(condy::co_spawn(pool, worker(i)));
+        }
+        // Block this runtime, so that all workers must be stolen
+        while (count < num_tasks) {
+            std::this_thread::yield();
+        }
+        for (auto &task : tasks) {
+            co_await std::move(task);
+        }
+        pool.allow_exit();
+    };
+
+    auto task = condy::co_spawn(pool, spawner());
+    pool.run();
+    task.wait();
+
+    for (auto &id : ids) {
+        REQUIRE(id != spawner_id);
+    }
+}
+
+TEST_CASE("test runtime_pool - sync_wait") {
+    condy::RuntimePool pool(3, options);
+
+    auto inner = [](int i) -> condy::Coro<int> { co_return i; };
+
+    auto func = [&]() -> condy::Coro<int> {
+        std::vector<condy::Task<int>> tasks;
+        for (int i = 0; i < 10; i++) {
+            tasks.push_back(condy::co_spawn(pool, inner(i)));
+        }
+        int sum = 0;
+        for (auto &task : tasks) {
+            sum += co_await std::move(task);
+        }
+        co_return sum;
+    };
+
+    REQUIRE(condy::sync_wait(pool, func()) == 45);
+}
+
+TEST_CASE("test runtime_pool - sync_wait on all runtimes") {
+    using namespace std::chrono_literals;
+
+    // Submit the doorbells to sleeping peers while this runtime is busy
+    auto opts = condy::RuntimeOptions(options).submit_batch(1);
+    condy::RuntimePool pool(4, opts);
+
+    std::mutex mutex;
+    std::set<std::thread::id> ids;
+    auto worker = [&]() -> condy::Coro<void> {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ids.insert(std::this_thread::get_id());
+        }
+        // Keep this runtime busy, so that idle peers steal the others
+        std::this_thread::sleep_for(1ms);
+        co_return;
+    };
+
+    auto func = [&]() -> condy::Coro<void> {
+        // Spawn once the other runtimes had time to become idle
+        co_await condy::async_sleep(20ms);
+        std::vector<condy::Task<void>> tasks;
+        for (int i = 0; i < 32; i++) {
+            tasks.push_back(condy::co_spawn(pool, worker()));
+        }
+        for (auto &task : tasks) {
+            co_await std::move(task);
+        }
+    };
+
+    // Exit is allowed before the tasks are spawned, idle runtimes must still
+    // wait for them
+    condy::sync_wait(pool, func());
+    REQUIRE(ids.size() > 1);
+}
@@ -0,0 +1,151 @@
+#include "condy/async_operations.hpp"
+#include "condy/awaiter_operations.hpp"
+#include "condy/coro.hpp"
+#include "condy/runtime.hpp"
+#include "condy/runtime_options.hpp"
+#include "condy/rwlock.hpp"
+#include "condy/sync_wait.hpp"
+#include "condy/task.hpp"
+#include <cerrno>
+#include <cstddef>
+#include <doctest/doctest.h>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+auto options = condy::RuntimeOptions().sq_size(8).cq_size(16);
+
+} // namespace
+
+TEST_CASE("test rwlock - try lock") {
+    condy::AsyncRWLock rwlock;
+    REQUIRE(rwlock.try_lock_shared());
+    REQUIRE(rwlock.try_lock_shared());
+    REQUIRE(!rwlock.try_lock());
+    rwlock.unlock_shared();
+    rwlock.unlock_shared();
+
+    REQUIRE(rwlock.try_lock());
+    REQUIRE(!rwlock.try_lock());
+    REQUIRE(!rwlock.try_lock_shared());
+    rwlock.unlock();
+    REQUIRE(rwlock.try_lock_shared());
+    rwlock.unlock_shared();
+}
+
+TEST_CASE("test rwlock - writer not starved") {
+    condy::AsyncRWLock rwlock;
+
+    std::vector<int> order;
+    auto writer = [&]() -> condy::Coro<void> {
+        REQUIRE(co_await rwlock.lock() == 0);
+        order.push_back(0);
+        rwlock.unlock();
+    };
+    auto reader = [&](int i) -> condy::Coro<void> {
+        REQUIRE(co_await rwlock.lock_shared() == 0);
+        order.push_back(i);
+        co_await condy::async_nop();
+        rwlock.unlock_shared();
+    };
+
+    auto func = [&]() -> condy::Coro<void> {
+        REQUIRE(co_await rwlock.lock_shared() == 0);
+        auto t1 = condy::co_spawn(writer());
+        co_await condy::async_nop();
+        // Readers queue behind the awaiting writer
+        REQUIRE(!rwlock.try_lock_shared());
+        auto t2 = condy::co_spawn(reader(1));
+        auto t3 = condy::co_spawn(reader(2));
+        co_await condy::async_nop();
+        REQUIRE(order.empty());
+
+        rwlock.unlock_shared();
+        co_await std::move(t1);
+        co_await std::move(t2);
+        co_await std::move(t3);
+        REQUIRE(order == std::vector<int>{0, 1, 2});
+    };
+
+    condy::Runtime runtime(options);
+    condy::sync_wait(runtime, func());
+}
+
+TEST_CASE("test rwlock - cancel lock") {
+    using condy::operators::operator||;
+
+    condy::AsyncRWLock rwlock;
+
+    auto reader = [&]() -> condy::Coro<void> {
+        REQUIRE(co_await rwlock.lock_shared() == 0);
+        rwlock.unlock_shared();
+    };
+
+    auto func = [&]() -> condy::Coro<void> {
+        REQUIRE(co_await rwlock.lock_shared() == 0);
+
+        auto t = condy::co_spawn(reader());
+        __kernel_timespec ts{
+            .tv_sec = 0,
+            .tv_nsec = 1000000,
+        };
+        // The reader queued behind the cancelled writer proceeds
+        auto r = co_await (rwlock.lock() || condy::async_timeout(&ts, 0, 0));
+        REQUIRE(r.index() == 1);
+        co_await std::move(t);
+
+        rwlock.unlock_shared();
+        REQUIRE(rwlock.try_lock());
+        rwlock.unlock();
+    };
+
+    condy::Runtime runtime(options);
+    condy::sync_wait(runtime, func());
+}
+
+TEST_CASE("test rwlock - across runtimes") {
+    condy::AsyncRWLock rwlock;
+
+    const size_t num_runtimes = 4;
+    const size_t num_iterations = 500;
+
+    size_t value = 0;
+    size_t shadow = 0;
+    auto worker = [&](size_t id) -> condy::Coro<void> {
+        for (size_t i = 0; i < num_iterations; ++i) {
+            if ((i + id) % 4 == 0) {
+                REQUIRE(co_await rwlock.lock() == 0);
+                value++;
+                shadow++;
+                rwlock.unlock();
+            } else {
+                REQUIRE(co_await rwlock.lock_shared() == 0);
+                REQUIRE(value == shadow);
+                rwlock.unlock_shared();
+            }
+        }
+    };
+
+    std::vector<std::unique_ptr<condy::Runtime>> runtimes;
+    std::vector<std::thread> threads;
+    std::vector<condy::Task<void>> tasks;
+    for (size_t i = 0; i < num_runtimes; ++i) {
+        runtimes.push_back(std::make_unique<condy::Runtime>(options));
+        tasks.push_back(condy::co_spawn(*runtimes.back(), worker(i)));
+    }
+    for (auto &runtime : runtimes) {
+        threads.emplace_back([&runtime]() {
+            runtime->allow_exit();
+            runtime->run();
+        });
+    }
+    for (auto &task : tasks) {
+        task.wait();
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    REQUIRE(value == num_runtimes * num_iterations / 4);
+}
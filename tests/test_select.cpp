@@ -0,0 +1,218 @@
+#include "condy/async_operations.hpp"
+#include "condy/awaiter_operations.hpp"
+#include "condy/channel.hpp"
+#include "condy/coro.hpp"
+#include "condy/runtime.hpp"
+#include "condy/runtime_options.hpp"
+#include "condy/select.hpp"
+#include "condy/sync_wait.hpp"
+#include "condy/task.hpp"
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <doctest/doctest.h>
+#include <memory>
+#include <thread>
+#include <variant>
+#include <vector>
+
+namespace {
+
+auto options = condy::RuntimeOptions().sq_size(8).cq_size(16);
+
+} // namespace
+
+TEST_CASE("test select - ready channels") {
+    condy::Channel<int> ch1(2), ch2(2);
+
+    auto func = [&]() -> condy::Coro<void> {
+        REQUIRE(ch1.try_push(1) == 0);
+        REQUIRE(ch2.try_push(2) == 0);
+
+        // Earlier channels take priority
+        auto r1 = co_await condy::select(ch1, ch2);
+        REQUIRE(r1.index() == 0);
+        REQUIRE(std::get<0>(r1).first == 0);
+        REQUIRE(std::get<0>(r1).second == 1);
+
+        auto r2 = co_await condy::select(ch1, ch2);
+        REQUIRE(r2.index() == 1);
+        REQUIRE(std::get<1>(r2).first == 0);
+        REQUIRE(std::get<1>(r2).second == 2);
+    };
+
+    condy::Runtime runtime(options);
+    condy::sync_wait(runtime, func());
+}
+
+TEST_CASE("test select - await channels") {
+    condy::Runtime runtime(options);
+    condy::Channel<int> ch1(1), ch2(1);
+
+    std::atomic_bool finished = false;
+
+    auto func = [&]() -> condy::Coro<void> {
+        auto r = co_await condy::select(ch1, ch2);
+        REQUIRE(r.index() == 1);
+        REQUIRE(std::get<1>(r).first == 0);
+        REQUIRE(std::get<1>(r).second == 42);
+        finished = true;
+    };
+
+    condy::co_spawn(runtime, func()).detach();
+
+    std::thread t([&]() {
+        runtime.allow_exit();
+        runtime.run();
+    });
+
+    REQUIRE(!finished);
+    REQUIRE(ch2.try_push(42) == 0);
+
+    t.join();
+    REQUIRE(finished);
+
+    // The losing registration must not take the item
+    REQUIRE(ch1.try_push(43) == 0);
+    auto [r, item] = ch1.try_pop();
+    REQUIRE(r == 0);
+    REQUIRE(item == 43);
+}
+
+TEST_CASE("test select - cancel select") {
+    using condy::operators::operator||;
+
+    condy::Channel<int> ch1(1), ch2(1);
+
+    auto func = [&]() -> condy::Coro<void> {
+        __kernel_timespec ts{
+            .tv_sec = 0,
+            .tv_nsec = 1000000,
+        };
+        auto r = co_await (condy::select(ch1, ch2) ||
+                           condy::async_timeout(&ts, 0, 0));
+        REQUIRE(r.index() == 1);
+
+        // The cancelled select must not take any item
+        REQUIRE(ch1.try_push(1) == 0);
+        REQUIRE(ch2.try_push(2) == 0);
+        REQUIRE(ch1.try_pop().second == 1);
+        REQUIRE(ch2.try_pop().second == 2);
+    };
+
+    condy::Runtime runtime(options);
+    condy::sync_wait(runtime, func());
+}
+
+TEST_CASE("test select - drop losing registrations") {
+    condy::Channel<int> ch1(1), ch2(1);
+
+    auto pusher = [&]() -> condy::Coro<void> {
+        // The select is claimed by ch2, then ch1 meets its registration
+        // before the select runs again
+        REQUIRE(ch2.try_push(2) == 0);
+        REQUIRE(ch1.try_push(1) == 0);
+        co_return;
+    };
+
+    auto func = [&]() -> condy::Coro<void> {
+        auto t = condy::co_spawn(pusher());
+        auto r = co_await condy::select(ch1, ch2);
+        REQUIRE(r.index() == 1);
+        REQUIRE(std::get<1>(r).second == 2);
+        co_await std::move(t);
+
+        // The item is left in ch1 for later pops
+        auto [r2, item] = ch1.try_pop();
+        REQUIRE(r2 == 0);
+        REQUIRE(item == 1);
+    };
+
+    condy::Runtime runtime(options);
+    condy::sync_wait(runtime, func());
+}
+
+TEST_CASE("test select - closed and unbuffered channels") {
+    condy::Channel<int> ctrl(1);
+    condy::Channel<std::unique_ptr<int>> data(0);
+
+    const int max_items = 10;
+
+    auto producer = [&]() -> condy::Coro<void> {
+        for (int i = 1; i <= max_items; ++i) {
+            REQUIRE(co_await data.push(std::make_unique<int>(i)) == 0);
+        }
+        ctrl.push_close();
+    };
+
+    auto func = [&]() -> condy::Coro<void> {
+        auto t = condy::co_spawn(producer());
+        int expected = 1;
+        while (true) {
+            auto r = co_await condy::select(ctrl, data);
+            if (r.index() == 0) {
+                REQUIRE(std::get<0>(r).first == -EPIPE);
+                break;
+            }
+            auto &[r2, item] = std::get<1>(r);
+            REQUIRE(r2 == 0);
+            REQUIRE(*item == expected++);
+        }
+        REQUIRE(expected == max_items + 1);
+        co_await std::move(t);
+    };
+
+    condy::Runtime runtime(options);
+    condy::sync_wait(runtime, func());
+}
+
+TEST_CASE("test select - cross runtimes") {
+    condy::Channel<int> ch1(4), ch2(4);
+
+    const int max_items = 1000;
+    const size_t num_producers = 2;
+
+    auto producer = [&](condy::Channel<int> &channel) -> condy::Coro<void> {
+        for (int i = 1; i <= max_items; ++i) {
+            REQUIRE(co_await channel.push(i) == 0);
+        }
+    };
+
+    std::vector<std::unique_ptr<condy::Runtime>> runtimes;
+    std::vector<std::thread> threads;
+    std::vector<condy::Task<void>> tasks;
+    for (size_t i = 0; i < num_producers; ++i) {
+        runtimes.push_back(std::make_unique<condy::Runtime>(options));
+        auto &channel = i == 0 ? ch1 : ch2;
+        tasks.push_back(condy::co_spawn(*runtimes.back(), producer(channel)));
+    }
+    for (auto &runtime : runtimes) {
+        threads.emplace_back([&runtime]() {
+            runtime->allow_exit();
+            runtime->run();
+        });
+    }
+
+    auto consumer = [&]() -> condy::Coro<void> {
+        int expected[2] = {1, 1};
+        for (int i = 0; i < 2 * max_items; ++i) {
+            auto r = co_await condy::select(ch1, ch2);
+            auto [r2, item] =
+                r.index() == 0 ? std::get<0>(r) : std::get<1>(r);
+            REQUIRE(r2 == 0);
+            REQUIRE(item == expected[r.index()]++);
+        }
+        REQUIRE(expected[0] == max_items + 1);
+        REQUIRE(expected[1] == max_items + 1);
+    };
+
+    condy::Runtime runtime(options);
+    condy::sync_wait(runtime, consumer());
+
+    for (auto &task : tasks) {
+        task.wait();
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
@@ -0,0 +1,152 @@
+#include "condy/async_operations.hpp"
+#include "condy/awaiter_operations.hpp"
+#include "condy/coro.hpp"
+#include "condy/runtime.hpp"
+#include "condy/runtime_options.hpp"
+#include "condy/semaphore.hpp"
+#include "condy/sync_wait.hpp"
+#include "condy/task.hpp"
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <doctest/doctest.h>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+auto options = condy::RuntimeOptions().sq_size(8).cq_size(16);
+
+} // namespace
+
+TEST_CASE("test semaphore - try acquire") {
+    condy::AsyncSemaphore semaphore(2);
+    REQUIRE(semaphore.available() == 2);
+    REQUIRE(semaphore.try_acquire());
+    REQUIRE(semaphore.try_acquire());
+    REQUIRE(!semaphore.try_acquire());
+    semaphore.release(2);
+    REQUIRE(semaphore.available() == 2);
+}
+
+TEST_CASE("test semaphore - fifo handoff") {
+    condy::AsyncSemaphore semaphore(0);
+
+    std::vector<int> order;
+    auto waiter = [&](int i) -> condy::Coro<void> {
+        REQUIRE(co_await semaphore.acquire() == 0);
+        order.push_back(i);
+    };
+
+    auto func = [&]() -> condy::Coro<void> {
+        std::vector<condy::Task<void>> tasks;
+        for (int i = 0; i < 3; ++i) {
+            tasks.push_back(condy::co_spawn(waiter(i)));
+        }
+        co_await condy::async_nop();
+        REQUIRE(order.empty());
+
+        // Awaiting operations are served before newcomers
+        semaphore.release();
+        REQUIRE(!semaphore.try_acquire());
+        semaphore.release(2);
+        for (auto &task : tasks) {
+            co_await std::move(task);
+        }
+        REQUIRE(order == std::vector<int>{0, 1, 2});
+        REQUIRE(semaphore.available() == 0);
+    };
+
+    condy::Runtime runtime(options);
+    condy::sync_wait(runtime, func());
+}
+
+TEST_CASE("test semaphore - cancel acquire") {
+    using condy::operators::operator||;
+
+    condy::AsyncSemaphore semaphore(0);
+
+    auto func = [&]() -> condy::Coro<void> {
+        __kernel_timespec ts{
+            .tv_sec = 0,
+            .tv_nsec = 1000000,
+        };
+        auto r =
+            co_await (semaphore.acquire() || condy::async_timeout(&ts, 0, 0));
+        REQUIRE(r.index() == 1);
+
+        // The cancelled acquire must not take the permit
+        semaphore.release();
+        REQUIRE(semaphore.available() == 1);
+        REQUIRE(co_await semaphore.acquire() == 0);
+    };
+
+    condy::Runtime runtime(options);
+    condy::sync_wait(runtime, func());
+}
+
+TEST_CASE("test semaphore - mutex") {
+    condy::AsyncMutex mutex;
+
+    size_t counter = 0;
+    auto worker = [&]() -> condy::Coro<void> {
+        for (int i = 0; i < 100; ++i) {
+            REQUIRE(co_await mutex.lock() == 0);
+            size_t value = counter;
+            // Yield while holding the lock
+            co_await condy::async_nop();
+            counter = value + 1;
+            mutex.unlock();
+        }
+    };
+
+    auto func = [&]() -> condy::Coro<void> {
+        auto t1 = condy::co_spawn(worker());
+        auto t2 = condy::co_spawn(worker());
+        co_await std::move(t1);
+        co_await std::move(t2);
+    };
+
+    condy::Runtime runtime(options);
+    condy::sync_wait(runtime, func());
+    REQUIRE(counter == 200);
+    REQUIRE(mutex.try_lock());
+}
+
+TEST_CASE("test semaphore - mutex across runtimes") {
+    condy::AsyncMutex mutex;
+
+    const size_t num_runtimes = 4;
+    const size_t num_iterations = 1000;
+
+    size_t counter = 0;
+    auto worker = [&]() -> condy::Coro<void> {
+        for (size_t i = 0; i < num_iterations; ++i) {
+            REQUIRE(co_await mutex.lock() == 0);
+            counter++;
+            mutex.unlock();
+        }
+    };
+
+    std::vector<std::unique_ptr<condy::Runtime>> runtimes;
+    std::vector<std::thread> threads;
+    std::vector<condy::Task<void>> tasks;
+    for (size_t i = 0; i < num_runtimes; ++i) {
+        runtimes.push_back(std::make_unique<condy::Runtime>(options));
+        tasks.push_back(condy::co_spawn(*runtimes.back(), worker()));
+    }
+    for (auto &runtime : runtimes) {
+        threads.emplace_back([&runtime]() {
+            runtime->allow_exit();
+            runtime->run();
+        });
+    }
+    for (auto &task : tasks) {
+        task.wait();
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    REQUIRE(counter == num_runtimes * num_iterations);
+}
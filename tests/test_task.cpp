@@ -1,10 +1,17 @@
+#include "condy/async_operations.hpp"
 #include "condy/awaiter_operations.hpp"
+#include "condy/buffers.hpp"
+#include "condy/local_channel.hpp"
+#include "condy/priority.hpp"
 #include "condy/runtime.hpp"
 #include "condy/runtime_options.hpp"
 #include "condy/task.hpp"
 #include <doctest/doctest.h>
+#include <optional>
 #include <stdexcept>
 #include <thread>
+#include <unistd.h>
+#include <vector>
 
 namespace {
 
@@ -447,4 +454,126 @@ TEST_CASE("test task - co_switch") {
     rt2_thread.join();
 
     REQUIRE(task_finished);
-}
\ No newline at end of file
+}
+TEST_CASE("test task - yield_now") {
+    condy::Runtime runtime(options);
+
+    std::vector<int> order;
+    auto func = [&](int id) -> condy::Coro<void> {
+        for (int i = 0; i < 3; ++i) {
+            order.push_back(id);
+            co_await condy::yield_now();
+        }
+    };
+
+    condy::co_spawn(runtime, func(1)).detach();
+    condy::co_spawn(runtime, func(2)).detach();
+    runtime.allow_exit();
+    runtime.run();
+
+    REQUIRE(order == std::vector<int>{1, 2, 1, 2, 1, 2});
+    // No operation is submitted to yield
+    REQUIRE(runtime.stats().submitted_sqes == 0);
+}
+
+TEST_CASE("test task - spawn with priority") {
+    condy::Runtime runtime(options);
+
+    std::vector<int> order;
+    auto func = [&](int id) -> condy::Coro<void> {
+        order.push_back(id);
+        co_return;
+    };
+    auto parent = [&]() -> condy::Coro<void> {
+        order.push_back(0);
+        // Children inherit the priority of the parent
+        condy::co_spawn(func(4)).detach();
+        condy::co_spawn(func(5), condy::TaskPriority::Low).detach();
+        co_return;
+    };
+
+    condy::co_spawn(runtime, func(3), condy::TaskPriority::Low).detach();
+    condy::co_spawn(runtime, func(2)).detach();
+    condy::co_spawn(runtime, func(1), condy::TaskPriority::High).detach();
+    condy::co_spawn(runtime, parent(), condy::TaskPriority::High).detach();
+    runtime.allow_exit();
+    runtime.run();
+
+    REQUIRE(order == std::vector<int>{1, 0, 4, 2, 3, 5});
+}
+
+TEST_CASE("test task - priority at spawn and wake up") {
+    condy::Runtime runtime(options);
+    condy::LocalChannel<int> channel(1);
+
+    std::vector<int> order;
+    std::optional<condy::Coro<void>> pending;
+    auto func = [&](int id) -> condy::Coro<void> {
+        order.push_back(id);
+        co_return;
+    };
+    auto waiter = [&]() -> condy::Coro<void> {
+        auto [r, item] = co_await channel.pop();
+        REQUIRE(r == 0);
+        order.push_back(item);
+    };
+    auto high = [&]() -> condy::Coro<void> {
+        // Created by a high task, but spawned by a normal one
+        pending.emplace(func(3));
+        co_return;
+    };
+    auto normal = [&]() -> condy::Coro<void> {
+        condy::co_spawn(std::move(*pending)).detach();
+        condy::co_spawn(func(2)).detach();
+        // The waiter is woken up with the priority it had when it started
+        // waiting, ahead of the normal tasks
+        REQUIRE(channel.try_push(1) == 0);
+        co_return;
+    };
+
+    condy::co_spawn(runtime, waiter(), condy::TaskPriority::High).detach();
+    condy::co_spawn(runtime, high(), condy::TaskPriority::High).detach();
+    condy::co_spawn(runtime, normal()).detach();
+    runtime.allow_exit();
+    runtime.run();
+
+    REQUIRE(order == std::vector<int>{1, 3, 2});
+}
+
+TEST_CASE("test task - priority of io") {
+    int fds[2];
+    REQUIRE(pipe(fds) == 0);
+
+    auto func = [&]() -> condy::Coro<void> {
+        char buf[4] = {};
+        REQUIRE(co_await condy::async_write(fds[1], condy::buffer("abc", 3),
+                                            0) == 3);
+        REQUIRE(co_await condy::async_read(fds[0], condy::buffer(buf, 3),
+                                           0) == 3);
+    };
+
+    condy::Runtime runtime(options);
+    for (auto priority : {condy::TaskPriority::High,
+                          condy::TaskPriority::Normal,
+                          condy::TaskPriority::Low}) {
+        condy::co_spawn(runtime, func(), priority).detach();
+    }
+    runtime.allow_exit();
+    runtime.run();
+
+    close(fds[0]);
+    close(fds[1]);
+
+    io_uring_sqe sqe = {};
+    io_uring_prep_read(&sqe, 0, nullptr, 0, 0);
+    condy::detail::prep_priority(&sqe, condy::TaskPriority::Normal);
+    REQUIRE(sqe.ioprio == 0);
+    condy::detail::prep_priority(&sqe, condy::TaskPriority::Low);
+    REQUIRE(sqe.ioprio == condy::detail::ioprio_best_effort(7));
+
+    // The ioprio field of other opcodes is left alone
+    sqe = {};
+    io_uring_prep_recv(&sqe, 0, nullptr, 0, 0);
+    condy::detail::prep_priority(&sqe, condy::TaskPriority::High);
+    REQUIRE(sqe.ioprio == 0);
+}
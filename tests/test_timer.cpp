@@ -0,0 +1,174 @@
+#include "condy/async_operations.hpp"
+#include "condy/awaiter_operations.hpp"
+#include "condy/channel.hpp"
+#include "condy/coro.hpp"
+#include "condy/runtime.hpp"
+#include "condy/runtime_options.hpp"
+#include "condy/sync_wait.hpp"
+#include "condy/task.hpp"
+#include "condy/timer.hpp"
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <doctest/doctest.h>
+#include <functional>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+namespace {
+
+auto options = condy::RuntimeOptions().sq_size(8).cq_size(16);
+
+struct WithCancelReceiver {
+    std::function<void(int)> callback;
+    std::stop_token token;
+    void operator()(int result) noexcept { callback(result); }
+    auto get_stop_token() const noexcept { return token; }
+};
+
+// Sleep in a runtime thread, and request to stop it from this thread
+int32_t sleep_and_stop_from_other_thread(std::chrono::milliseconds duration) {
+    condy::Runtime runtime(options);
+    condy::Channel<int> channel(1);
+    std::stop_source stop_source;
+    std::atomic_bool started = false;
+    int32_t result = 0;
+
+    auto func = [&]() -> condy::Coro<void> {
+        auto op_state = condy::async_sleep(duration).connect(WithCancelReceiver{
+            .callback =
+                [&](int r) { REQUIRE(channel.try_push(r) == 0); },
+            .token = stop_source.get_token(),
+        });
+        op_state.start(0);
+        started = true;
+        started.notify_one();
+        auto [r, item] = co_await channel.pop();
+        REQUIRE(r == 0);
+        result = item;
+    };
+
+    condy::co_spawn(runtime, func()).detach();
+
+    std::thread t([&]() {
+        runtime.allow_exit();
+        runtime.run();
+    });
+
+    started.wait(false);
+    stop_source.request_stop();
+
+    t.join();
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("test timer - sleep") {
+    using namespace std::chrono_literals;
+
+    auto func = [&]() -> condy::Coro<void> {
+        auto start = std::chrono::steady_clock::now();
+        REQUIRE(co_await condy::async_sleep(20ms) == -ETIME);
+        REQUIRE(std::chrono::steady_clock::now() - start >= 20ms);
+
+        // Deadlines in the past complete immediately
+        REQUIRE(co_await condy::async_sleep_until(start) == -ETIME);
+        REQUIRE(co_await condy::async_sleep(0ms) == -ETIME);
+    };
+
+    condy::Runtime runtime(options);
+    condy::sync_wait(runtime, func());
+}
+
+TEST_CASE("test timer - expire in order") {
+    using namespace std::chrono_literals;
+
+    std::vector<int> order;
+    auto start = std::chrono::steady_clock::now();
+    auto sleeper = [&](int i, std::chrono::milliseconds offset)
+        -> condy::Coro<void> {
+        REQUIRE(co_await condy::async_sleep_until(start + offset) == -ETIME);
+        order.push_back(i);
+    };
+
+    auto func = [&]() -> condy::Coro<void> {
+        auto t1 = condy::co_spawn(sleeper(3, 30ms));
+        auto t2 = condy::co_spawn(sleeper(1, 20ms));
+        auto t3 = condy::co_spawn(sleeper(2, 25ms));
+        // An earlier timer added after a later one rearms the kernel timeout.
+        // Deadlines are fixed from the start, so the order does not depend on
+        // how long this takes.
+        co_await condy::async_nop();
+        auto t4 = condy::co_spawn(sleeper(0, 1ms));
+        co_await std::move(t1);
+        co_await std::move(t2);
+        co_await std::move(t3);
+        co_await std::move(t4);
+        REQUIRE(order == std::vector<int>{0, 1, 2, 3});
+    };
+
+    condy::Runtime runtime(options);
+    condy::sync_wait(runtime, func());
+}
+
+TEST_CASE("test timer - cancel") {
+    using condy::operators::operator||;
+    using namespace std::chrono_literals;
+
+    auto func = [&]() -> condy::Coro<void> {
+        auto start = std::chrono::steady_clock::now();
+        auto r = co_await (condy::async_sleep(10s) || condy::async_nop());
+        REQUIRE(r.index() == 1);
+        REQUIRE(std::chrono::steady_clock::now() - start < 5s);
+
+        r = co_await (condy::async_sleep(1ms) || condy::async_sleep(10s));
+        REQUIRE(r.index() == 0);
+    };
+
+    condy::Runtime runtime(options);
+    condy::sync_wait(runtime, func());
+}
+
+TEST_CASE("test timer - many timers") {
+    using condy::operators::operator||;
+    using namespace std::chrono_literals;
+
+    const size_t num_timers = 1000;
+
+    auto sleeper = [&]() -> condy::Coro<void> {
+        // Most timers are cancelled before they fire
+        auto r = co_await (condy::async_sleep(10s) || condy::async_sleep(5ms));
+        REQUIRE(r.index() == 1);
+    };
+
+    auto func = [&]() -> condy::Coro<void> {
+        std::vector<condy::Task<void>> tasks;
+        for (size_t i = 0; i < num_timers; ++i) {
+            tasks.push_back(condy::co_spawn(sleeper()));
+        }
+        for (auto &task : tasks) {
+            co_await std::move(task);
+        }
+    };
+
+    condy::Runtime runtime(options);
+    condy::sync_wait(runtime, func());
+    // All timers share a few kernel timeouts
+    REQUIRE(runtime.stats().submitted_sqes < 100);
+}
+
+TEST_CASE("test timer - cancel from other thread") {
+    using namespace std::chrono_literals;
+
+    REQUIRE(sleep_and_stop_from_other_thread(10s) == -ECANCELED);
+
+    // Racing with the deadline, the timer either expires or is cancelled
+    for (int i = 0; i < 50; ++i) {
+        auto r = sleep_and_stop_from_other_thread(1ms);
+        REQUIRE((r == -ETIME || r == -ECANCELED));
+    }
+}
@@ -0,0 +1,87 @@
+#include "condy/timer_wheel.hpp"
+#include <cstdint>
+#include <doctest/doctest.h>
+#include <vector>
+
+namespace {
+
+struct Timer : public condy::detail::TimerHandle {};
+
+std::vector<uint64_t> advance(condy::detail::TimerWheel &wheel, uint64_t now) {
+    std::vector<uint64_t> expired;
+    wheel.advance(now, [&](condy::detail::TimerHandle *handle) {
+        REQUIRE(handle->deadline() <= now);
+        expired.push_back(handle->deadline());
+    });
+    return expired;
+}
+
+} // namespace
+
+TEST_CASE("test timer_wheel - expire in order") {
+    condy::detail::TimerWheel wheel;
+    REQUIRE(wheel.empty());
+    REQUIRE(!wheel.next_expiration().has_value());
+
+    std::vector<uint64_t> deadlines = {5, 1, 63, 64, 100, 4095, 4096, 300000};
+    std::vector<Timer> timers(deadlines.size());
+    for (size_t i = 0; i < deadlines.size(); ++i) {
+        REQUIRE(wheel.insert(&timers[i], deadlines[i]));
+    }
+    REQUIRE(wheel.size() == deadlines.size());
+    REQUIRE(wheel.next_expiration() == 1);
+
+    REQUIRE(advance(wheel, 0).empty());
+    REQUIRE(advance(wheel, 5) == std::vector<uint64_t>{1, 5});
+    REQUIRE(advance(wheel, 99) == std::vector<uint64_t>{63, 64});
+    REQUIRE(advance(wheel, 5000) == std::vector<uint64_t>{100, 4095, 4096});
+    REQUIRE(wheel.elapsed() == 5000);
+    REQUIRE(wheel.size() == 1);
+    REQUIRE(advance(wheel, 1000000) == std::vector<uint64_t>{300000});
+    REQUIRE(wheel.empty());
+
+    // Deadlines not after the current time are rejected
+    Timer timer;
+    REQUIRE(!wheel.insert(&timer, 1000000));
+}
+
+TEST_CASE("test timer_wheel - remove") {
+    condy::detail::TimerWheel wheel;
+
+    Timer t1, t2, t3;
+    REQUIRE(wheel.insert(&t1, 10));
+    REQUIRE(wheel.insert(&t2, 10));
+    REQUIRE(wheel.insert(&t3, 1000));
+
+    REQUIRE(wheel.remove(&t1));
+    REQUIRE(!wheel.remove(&t1));
+    REQUIRE(wheel.remove(&t3));
+    REQUIRE(wheel.next_expiration() == 10);
+
+    REQUIRE(advance(wheel, 2000) == std::vector<uint64_t>{10});
+    REQUIRE(!wheel.remove(&t2));
+    REQUIRE(wheel.empty());
+    REQUIRE(!wheel.next_expiration().has_value());
+}
+
+TEST_CASE("test timer_wheel - far deadlines") {
+    condy::detail::TimerWheel wheel;
+
+    // Beyond the range of the wheel
+    const uint64_t far = uint64_t(1) << 40;
+    Timer t1, t2;
+    REQUIRE(wheel.insert(&t1, far));
+    REQUIRE(wheel.insert(&t2, far + 1));
+    REQUIRE(*wheel.next_expiration() <= far);
+
+    size_t steps = 0;
+    std::vector<uint64_t> expired;
+    while (auto expiration = wheel.next_expiration()) {
+        REQUIRE(*expiration > wheel.elapsed());
+        auto r = advance(wheel, *expiration);
+        expired.insert(expired.end(), r.begin(), r.end());
+        steps++;
+    }
+    REQUIRE(expired == std::vector<uint64_t>{far, far + 1});
+    REQUIRE(steps < 64);
+}
@@ -0,0 +1,128 @@
+#include "condy/async_operations.hpp"
+#include "condy/coro.hpp"
+#include "condy/runtime.hpp"
+#include "condy/runtime_options.hpp"
+#include "condy/sync_wait.hpp"
+#include "condy/task.hpp"
+#include "condy/unbounded_channel.hpp"
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <doctest/doctest.h>
+#include <memory>
+#include <thread>
+
+namespace {
+
+auto options = condy::RuntimeOptions().sq_size(8).cq_size(16);
+
+} // namespace
+
+TEST_CASE("test unbounded_channel - try push and pop") {
+    condy::UnboundedChannel<int, 4> channel;
+    REQUIRE(channel.empty());
+
+    // Grow and shrink several times, across segments
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < 100; ++i) {
+            REQUIRE(channel.try_push(i) == 0);
+        }
+        REQUIRE(channel.size() == 100);
+        for (int i = 0; i < 100; ++i) {
+            auto [r, item] = channel.try_pop();
+            REQUIRE(r == 0);
+            REQUIRE(item == i);
+        }
+        REQUIRE(channel.empty());
+        REQUIRE(channel.try_pop().first == -EAGAIN);
+    }
+
+    channel.push_close();
+    REQUIRE(channel.is_closed());
+    REQUIRE(channel.try_push(1) == -EPIPE);
+    REQUIRE(channel.try_pop().first == -EPIPE);
+}
+
+TEST_CASE("test unbounded_channel - destruct items") {
+    auto item = std::make_shared<int>(42);
+    {
+        condy::UnboundedChannel<std::shared_ptr<int>, 4> channel;
+        for (int i = 0; i < 10; ++i) {
+            REQUIRE(channel.try_push(std::shared_ptr<int>(item)) == 0);
+        }
+        REQUIRE(item.use_count() == 11);
+    }
+    REQUIRE(item.use_count() == 1);
+}
+
+TEST_CASE("test unbounded_channel - pop with coroutines") {
+    condy::UnboundedChannel<int, 4> channel;
+
+    const int max_items = 100;
+
+    auto consumer = [&]() -> condy::Coro<void> {
+        for (int i = 1; i <= max_items; ++i) {
+            auto [r, item] = co_await channel.pop();
+            REQUIRE(r == 0);
+            REQUIRE(item == i);
+        }
+        auto [r, item] = co_await channel.pop();
+        REQUIRE(r == -EPIPE);
+    };
+
+    auto func = [&]() -> condy::Coro<void> {
+        auto t = condy::co_spawn(consumer());
+        for (int i = 1; i <= max_items; ++i) {
+            channel.force_push(int(i));
+            if (i % 10 == 0) {
+                co_await condy::async_nop();
+            }
+        }
+        channel.push_close();
+        co_await std::move(t);
+    };
+
+    condy::Runtime runtime(options);
+    condy::sync_wait(runtime, func());
+}
+
+TEST_CASE("test unbounded_channel - cross runtimes") {
+    condy::UnboundedChannel<size_t> channel;
+
+    const size_t max_items = 10000;
+
+    std::atomic_size_t sum = 0;
+    auto consumer = [&]() -> condy::Coro<void> {
+        while (true) {
+            auto [r, item] = co_await channel.pop();
+            if (r == -EPIPE) {
+                break;
+            }
+            REQUIRE(r == 0);
+            sum += item;
+        }
+    };
+
+    condy::Runtime runtime1(options), runtime2(options);
+    auto task1 = condy::co_spawn(runtime1, consumer());
+    auto task2 = condy::co_spawn(runtime2, consumer());
+    std::thread t1([&]() {
+        runtime1.allow_exit();
+        runtime1.run();
+    });
+    std::thread t2([&]() {
+        runtime2.allow_exit();
+        runtime2.run();
+    });
+
+    for (size_t i = 1; i <= max_items; ++i) {
+        REQUIRE(channel.try_push(size_t(i)) == 0);
+    }
+    channel.push_close();
+
+    task1.wait();
+    task2.wait();
+    t1.join();
+    t2.join();
+    REQUIRE(sum == max_items * (max_items + 1) / 2);
+}
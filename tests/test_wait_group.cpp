@@ -0,0 +1,151 @@
+#include "condy/async_operations.hpp"
+#include "condy/awaiter_operations.hpp"
+#include "condy/coro.hpp"
+#include "condy/runtime.hpp"
+#include "condy/runtime_options.hpp"
+#include "condy/sync_wait.hpp"
+#include "condy/task.hpp"
+#include "condy/wait_group.hpp"
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <doctest/doctest.h>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+auto options = condy::RuntimeOptions().sq_size(8).cq_size(16);
+
+} // namespace
+
+TEST_CASE("test wait_group - fan out") {
+    condy::WaitGroup wg;
+
+    const size_t num_tasks = 100;
+    size_t finished = 0;
+    auto worker = [&]() -> condy::Coro<void> {
+        co_await condy::async_nop();
+        finished++;
+        wg.done();
+    };
+
+    auto func = [&]() -> condy::Coro<void> {
+        // Nothing to wait for
+        REQUIRE(co_await wg.wait() == 0);
+
+        wg.add(num_tasks);
+        for (size_t i = 0; i < num_tasks; ++i) {
+            condy::co_spawn(worker()).detach();
+        }
+        REQUIRE(co_await wg.wait() == 0);
+        REQUIRE(finished == num_tasks);
+        REQUIRE(wg.count() == 0);
+
+        // Reused after reaching zero
+        wg.add();
+        condy::co_spawn(worker()).detach();
+        REQUIRE(co_await wg.wait() == 0);
+        REQUIRE(finished == num_tasks + 1);
+    };
+
+    condy::Runtime runtime(options);
+    condy::sync_wait(runtime, func());
+}
+
+TEST_CASE("test wait_group - cancel wait") {
+    using condy::operators::operator||;
+
+    condy::WaitGroup wg;
+
+    auto func = [&]() -> condy::Coro<void> {
+        wg.add();
+        __kernel_timespec ts{
+            .tv_sec = 0,
+            .tv_nsec = 1000000,
+        };
+        auto r = co_await (wg.wait() || condy::async_timeout(&ts, 0, 0));
+        REQUIRE(r.index() == 1);
+
+        wg.done();
+        REQUIRE(co_await wg.wait() == 0);
+    };
+
+    condy::Runtime runtime(options);
+    condy::sync_wait(runtime, func());
+}
+
+TEST_CASE("test wait_group - across runtimes") {
+    condy::WaitGroup wg;
+
+    const size_t num_runtimes = 4;
+    const size_t num_tasks = 100;
+
+    std::atomic_size_t finished = 0;
+    auto worker = [&]() -> condy::Coro<void> {
+        co_await condy::async_nop();
+        finished.fetch_add(1, std::memory_order_relaxed);
+        wg.done();
+    };
+
+    auto waiter = [&]() -> condy::Coro<void> {
+        REQUIRE(co_await wg.wait() == 0);
+        REQUIRE(finished.load() == num_runtimes * num_tasks);
+    };
+
+    condy::Runtime main_runtime(options);
+    auto task = condy::co_spawn(main_runtime, waiter());
+
+    wg.add(num_runtimes * num_tasks);
+    std::vector<std::unique_ptr<condy::Runtime>> runtimes;
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < num_runtimes; ++i) {
+        runtimes.push_back(std::make_unique<condy::Runtime>(options));
+        for (size_t j = 0; j < num_tasks; ++j) {
+            condy::co_spawn(*runtimes.back(), worker()).detach();
+        }
+    }
+    for (auto &runtime : runtimes) {
+        threads.emplace_back([&runtime]() {
+            runtime->allow_exit();
+            runtime->run();
+        });
+    }
+    main_runtime.allow_exit();
+    main_runtime.run();
+    task.wait();
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
+
+TEST_CASE("test wait_group - latch") {
+    condy::Latch latch(3);
+
+    std::vector<int> order;
+    auto waiter = [&](int i) -> condy::Coro<void> {
+        REQUIRE(co_await latch.arrive_and_wait() == 0);
+        order.push_back(i);
+    };
+
+    auto func = [&]() -> condy::Coro<void> {
+        auto t1 = condy::co_spawn(waiter(1));
+        auto t2 = condy::co_spawn(waiter(2));
+        co_await condy::async_nop();
+        REQUIRE(!latch.try_wait());
+        REQUIRE(order.empty());
+
+        latch.count_down();
+        REQUIRE(latch.try_wait());
+        co_await std::move(t1);
+        co_await std::move(t2);
+        REQUIRE(order.size() == 2);
+
+        // Already open
+        REQUIRE(co_await latch.wait() == 0);
+    };
+
+    condy::Runtime runtime(options);
+    condy::sync_wait(runtime, func());
+}
@@ -24,4 +24,5 @@ TEST_CASE("test work_type - encode and decode") {
     test_type(condy::WorkType::Ignore);
     test_type(condy::WorkType::Schedule);
     test_type(condy::WorkType::Cancel);
+    test_type(condy::WorkType::Timer);
 }
\ No newline at end of file